@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_ALLOCATOR_HPP
+#define PROOF_GENERATOR_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Global operator new of the producer keeps heap usage under a limit by placing large allocations, which
+        // are polynomials and Merkle tree layers in practice, into mappings of unlinked scratch files. The kernel
+        // writes their cold pages out to the file and reads them back on access, instead of the process being
+        // killed when RAM is exhausted. Heap usage and allocations are counted only once accounting is enabled by
+        // a memory limit or by metrics, before that operator new is plain malloc.
+        struct AllocatorStatistics {
+            std::uint64_t heap_bytes;
+            // Sampled at allocations of at least min_spilled_allocation_size and at reads of the statistics
+            std::uint64_t peak_heap_bytes;
+            std::uint64_t spilled_bytes;
+            std::uint64_t peak_spilled_bytes;
+            // Calls of operator new, including the ones served by arenas
+            std::uint64_t allocations;
+            std::uint64_t arena_allocations;
+        };
+
+        // Allocations of at least this size go to scratch files once the limit is reached.
+        constexpr std::size_t min_spilled_allocation_size = 1 << 20;
+
+        // Blocks allocated before the call are not counted in heap usage.
+        void enable_allocation_accounting();
+
+        // Limit in bytes, scratch files are created in scratch_dir, which must not be on tmpfs or ramfs. Enables
+        // accounting. Must be called before any threads are started.
+        bool enable_memory_limit(std::uint64_t limit, const std::string& scratch_dir);
+
+        AllocatorStatistics allocator_statistics();
+
+        // Allocations of at most this size are taken from the active arena, larger ones go to the heap as usual.
+        constexpr std::size_t max_arena_allocation_size = 64 << 10;
+
+        // Bump allocator for short-lived structures made of many small blocks, like marshalled data decoded from a
+        // file. While an ArenaScope is active on a thread, small allocations of that thread are taken from the
+        // arena, their deletes do nothing, and the memory is freed at once when the arena is destroyed.
+        //
+        // Objects allocated in the scope must not outlive the arena. The producer opens scopes only around read()
+        // of a marshalling structure, which is declared after its arena and only copied from by the make_*
+        // conversions, so nothing allocated in a scope escapes it. Violations are only caught in debug builds,
+        // which assert when a block is deleted after its arena and reuse the memory of destroyed arenas as late as
+        // possible, so that a block used after its arena faults. Release builds reuse that memory for the next
+        // arena right away, there an escaped block reads or corrupts another arena.
+        class AllocationArena {
+        public:
+            AllocationArena() = default;
+            AllocationArena(const AllocationArena&) = delete;
+            AllocationArena& operator=(const AllocationArena&) = delete;
+            ~AllocationArena();
+
+            // nullptr if the block should come from the heap.
+            void* allocate(std::size_t size, std::size_t alignment) noexcept;
+
+        private:
+            // Chunks are linked through their first bytes
+            void* chunks_ = nullptr;
+            std::uint8_t* position_ = nullptr;
+            std::uint8_t* end_ = nullptr;
+            std::uint64_t allocations_ = 0;
+        };
+
+        class ArenaScope {
+        public:
+            explicit ArenaScope(AllocationArena& arena);
+            ArenaScope(const ArenaScope&) = delete;
+            ArenaScope& operator=(const ArenaScope&) = delete;
+            ~ArenaScope();
+
+        private:
+            AllocationArena* previous_;
+        };
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_ALLOCATOR_HPP
@@ -18,6 +18,8 @@
 #define PROOF_GENERATOR_ARG_PARSER_HPP
 
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/log/trivial.hpp>
@@ -35,26 +37,57 @@ namespace nil {
 
         struct ProverOptions {
             std::string stage = "all";
+            std::string proof_format = "hex";
+            // Empty means the default of the stage
+            std::string verification_mode;
             boost::filesystem::path proof_file_path = "proof.bin";
             boost::filesystem::path json_file_path = "proof.json";
+            // Proofs verified in 'verify' stage instead of proof_file_path, if not empty
+            std::vector<boost::filesystem::path> proof_file_paths;
             boost::filesystem::path preprocessed_common_data_path = "preprocessed_common_data.dat";
             boost::filesystem::path preprocessed_public_data_path = "preprocessed_data.dat";
             boost::filesystem::path commitment_scheme_state_path = "commitment_scheme_state.dat";
             boost::filesystem::path circuit_file_path;
             boost::filesystem::path assignment_table_file_path;
             boost::filesystem::path assignment_description_file_path;
+            boost::filesystem::path output_file_path;
+            boost::filesystem::path bundle_file_path;
+            boost::filesystem::path preprocessing_cache_path;
+            boost::filesystem::path checkpoint_dir_path;
+            boost::filesystem::path socket_path;
+            boost::filesystem::path batch_path;
+            boost::filesystem::path metrics_file_path;
+            boost::filesystem::path scratch_dir_path;
             boost::log::trivial::severity_level log_level = boost::log::trivial::severity_level::info;
             CurvesVariant elliptic_curve_type = type_identity<nil::crypto3::algebra::curves::pallas>{};
             HashesVariant hash_type = type_identity<nil::crypto3::hashes::keccak_1600<256>>{};
 
+            // zstd level of preprocessed data and commitment state files, 0 writes them uncompressed
+            int compression_level = 0;
             std::size_t lambda = 9;
-            std::size_t grind = 69;
+            // Proof-of-work bits of FRI, 0 disables grinding
+            std::size_t grind = 0;
             std::size_t expand_factor = 2;
             std::size_t max_quotient_chunks = 0;
+            std::size_t server_cache_size = 2;
+            // Zero means no limit
+            std::size_t preprocessing_cache_limit_mb = 0;
+            // Heap limit in MiB, 0 means no limit
+            std::size_t memory_limit_mb = 0;
+            std::size_t parallel_jobs = 1;
+            std::string cpu_pools;
+            bool numa_pools = false;
+            bool skip_json = false;
+            bool resume = false;
         };
 
         std::optional<ProverOptions> parse_args(int argc, char* argv[]);
 
+        std::ostream& operator<<(std::ostream& strm, const CurvesVariant& variant);
+        std::ostream& operator<<(std::ostream& strm, const HashesVariant& variant);
+        std::istream& operator>>(std::istream& strm, CurvesVariant& variant);
+        std::istream& operator>>(std::istream& strm, HashesVariant& variant);
+
     } // namespace proof_generator
 } // namespace nil
 
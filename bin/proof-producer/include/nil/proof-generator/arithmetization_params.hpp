@@ -19,6 +19,7 @@
 
 #include <array>
 #include <tuple>
+#include <type_traits>
 
 #include <nil/crypto3/algebra/curves/pallas.hpp>
 #include <nil/crypto3/algebra/curves/vesta.hpp>
@@ -31,9 +32,11 @@
 namespace nil {
     namespace proof_generator {
 
-        using CurveTypes = std::tuple<nil::crypto3::algebra::curves::pallas
-                                      // Add more curves as needed.
-                                      >;
+        using CurveTypes = std::tuple<
+            nil::crypto3::algebra::curves::pallas,
+            nil::crypto3::algebra::curves::vesta
+            // Add more curves as needed.
+            >;
 
         using HashTypes = std::tuple<
             nil::crypto3::hashes::keccak_1600<256>,
@@ -43,6 +46,15 @@ namespace nil {
             // Add more hashes as needed.
             >;
 
+        // Poseidon absorbs elements of its own field, so it is usable only with curves over that field. Unsupported
+        // pairs are not instantiated, keep PROOF_GENERATOR_UNSUPPORTED_PAIRS in CMakeLists.txt in sync.
+        template<typename CurveType, typename HashType>
+        struct is_supported_hash : std::true_type {};
+
+        template<typename CurveType, typename PoseidonPolicy>
+        struct is_supported_hash<CurveType, nil::crypto3::hashes::poseidon<PoseidonPolicy>>
+            : std::is_same<typename CurveType::base_field_type, typename PoseidonPolicy::field_type> {};
+
     } // namespace proof_generator
 } // namespace nil
 
@@ -0,0 +1,246 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_ASSIGNMENT_TABLE_FILE_HPP
+#define PROOF_GENERATOR_ASSIGNMENT_TABLE_FILE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+
+#include <nil/marshalling/field_type.hpp>
+#include <nil/marshalling/status_type.hpp>
+
+#include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+
+#include <nil/crypto3/zk/snark/arithmetization/plonk/table_description.hpp>
+
+#include <nil/proof-generator/parallel.hpp>
+#include <nil/proof-generator/sectioned_file.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Columnar assignment table: the header section holds the table description, then every column is a
+        // section of rows_amount field elements, each marshalled into a fixed-size slot. Columns go in the order
+        // witnesses, public inputs, constants, selectors, so any subset of them is decoded independently.
+        namespace detail {
+            constexpr std::uint64_t table_header_section_id = 0;
+            constexpr std::uint64_t table_first_column_section_id = 1;
+            constexpr std::size_t table_header_fields_count = 7;
+
+            template<typename Endianness, typename FieldValue>
+            using FieldElementMarshalling =
+                nil::crypto3::marshalling::types::field_element<nil::marshalling::field_type<Endianness>, FieldValue>;
+
+            // Marshalled length of a field element rounded up to 8 bytes, so slots stay aligned.
+            template<typename Endianness, typename FieldValue>
+            std::size_t table_element_size() {
+                const std::size_t length = FieldElementMarshalling<Endianness, FieldValue>().length();
+                return (length + 7) / 8 * 8;
+            }
+
+            template<typename Endianness, typename Column>
+            std::vector<std::uint8_t> encode_table_column(
+                const Column& column,
+                std::size_t rows_amount,
+                std::size_t element_size
+            ) {
+                using FieldValue = typename Column::value_type;
+
+                // Columns shorter than the table are padded with zeros, as the table does when it is resized
+                std::vector<std::uint8_t> data(rows_amount * element_size);
+                for (std::size_t i = 0; i < rows_amount; ++i) {
+                    const FieldValue value = i < column.size() ? column[i] : FieldValue::zero();
+                    FieldElementMarshalling<Endianness, FieldValue> element(value);
+                    std::uint8_t* iter = data.data() + i * element_size;
+                    element.write(iter, element_size);
+                }
+                return data;
+            }
+
+            template<typename Endianness, typename Column>
+            std::optional<Column> decode_table_column(
+                const SectionedFile::SectionView& section,
+                std::size_t rows_amount,
+                std::size_t element_size
+            ) {
+                using FieldValue = typename Column::value_type;
+
+                if (section.size != rows_amount * element_size) {
+                    return std::nullopt;
+                }
+                Column column(rows_amount);
+                for (std::size_t i = 0; i < rows_amount; ++i) {
+                    FieldElementMarshalling<Endianness, FieldValue> element;
+                    const std::uint8_t* iter = section.data + i * element_size;
+                    if (element.read(iter, element_size) != nil::marshalling::status_type::success) {
+                        return std::nullopt;
+                    }
+                    column[i] = element.value();
+                }
+                return column;
+            }
+        } // namespace detail
+
+        template<typename Endianness, typename AssignmentTable>
+        bool write_columnar_assignment_table(
+            const std::string& path,
+            const nil::crypto3::zk::snark::plonk_table_description<typename AssignmentTable::field_type>& description,
+            const AssignmentTable& table
+        ) {
+            using FieldValue = typename AssignmentTable::field_type::value_type;
+
+            const std::size_t element_size = detail::table_element_size<Endianness, FieldValue>();
+            const std::size_t columns_amount = description.witness_columns + description.public_input_columns +
+                                               description.constant_columns + description.selector_columns;
+
+            std::vector<Section> sections(1 + columns_amount);
+            sections[0].id = detail::table_header_section_id;
+            sections[0].data.resize(detail::table_header_fields_count * 8);
+            const std::uint64_t header_fields[detail::table_header_fields_count] = {
+                description.usable_rows_amount,
+                description.rows_amount,
+                description.witness_columns,
+                description.public_input_columns,
+                description.constant_columns,
+                description.selector_columns,
+                element_size
+            };
+            for (std::size_t i = 0; i < detail::table_header_fields_count; ++i) {
+                detail::store_le(sections[0].data.data() + 8 * i, header_fields[i], 8);
+            }
+
+            parallel_for(columns_amount, [&](std::size_t i) {
+                std::size_t index = i;
+                auto& section = sections[1 + i];
+                section.id = detail::table_first_column_section_id + i;
+                auto encode = [&](const auto& column) {
+                    section.data = detail::encode_table_column<Endianness>(column, description.rows_amount, element_size);
+                };
+                if (index < description.witness_columns) {
+                    return encode(table.witness(index));
+                }
+                index -= description.witness_columns;
+                if (index < description.public_input_columns) {
+                    return encode(table.public_input(index));
+                }
+                index -= description.public_input_columns;
+                if (index < description.constant_columns) {
+                    return encode(table.constant(index));
+                }
+                index -= description.constant_columns;
+                encode(table.selector(index));
+            });
+
+            return write_sectioned_file(path, SectionedFileKind::ASSIGNMENT_TABLE, sections);
+        }
+
+        // With private_only, constant and selector columns are not decoded and left empty.
+        template<typename Endianness, typename AssignmentTable>
+        std::optional<std::pair<
+            nil::crypto3::zk::snark::plonk_table_description<typename AssignmentTable::field_type>,
+            AssignmentTable>>
+            read_columnar_assignment_table(const std::string& path, bool private_only) {
+            using TableDescription = nil::crypto3::zk::snark::plonk_table_description<typename AssignmentTable::field_type>;
+            using FieldValue = typename AssignmentTable::field_type::value_type;
+            using Column = typename AssignmentTable::witnesses_container_type::value_type;
+
+            const auto file = SectionedFile::open(path, SectionedFileKind::ASSIGNMENT_TABLE);
+            if (!file.has_value()) {
+                return std::nullopt;
+            }
+
+            const auto header = file->section(detail::table_header_section_id);
+            if (!header.has_value() || header->size != detail::table_header_fields_count * 8) {
+                BOOST_LOG_TRIVIAL(error) << "Assignment table " << path << " has no valid header";
+                return std::nullopt;
+            }
+            std::uint64_t header_fields[detail::table_header_fields_count];
+            for (std::size_t i = 0; i < detail::table_header_fields_count; ++i) {
+                header_fields[i] = detail::load_le(header->data + 8 * i, 8);
+            }
+            TableDescription description(header_fields[2], header_fields[3], header_fields[4], header_fields[5]);
+            description.usable_rows_amount = header_fields[0];
+            description.rows_amount = header_fields[1];
+            const std::size_t element_size = header_fields[6];
+            if (element_size != detail::table_element_size<Endianness, FieldValue>()) {
+                BOOST_LOG_TRIVIAL(error) << "Assignment table " << path << " was written for another field";
+                return std::nullopt;
+            }
+
+            const std::size_t private_columns_amount = description.witness_columns + description.public_input_columns;
+            const std::size_t columns_amount = private_only ? private_columns_amount
+                                                            : private_columns_amount + description.constant_columns +
+                                                                  description.selector_columns;
+            std::vector<std::optional<Column>> columns(columns_amount);
+            parallel_for(columns_amount, [&](std::size_t i) {
+                const auto section = file->section(detail::table_first_column_section_id + i);
+                if (section.has_value()) {
+                    columns[i] = detail::decode_table_column<Endianness, Column>(
+                        *section, description.rows_amount, element_size
+                    );
+                }
+            });
+
+            for (std::size_t i = 0; i < columns_amount; ++i) {
+                if (!columns[i].has_value()) {
+                    BOOST_LOG_TRIVIAL(error) << "Column " << i << " of assignment table " << path << " is missing or corrupted";
+                    return std::nullopt;
+                }
+            }
+
+            auto take_columns = [&columns](std::size_t first, std::size_t count) {
+                std::vector<Column> result;
+                result.reserve(count);
+                for (std::size_t i = first; i < first + count; ++i) {
+                    result.push_back(std::move(*columns[i]));
+                }
+                return result;
+            };
+            std::size_t first = 0;
+            auto witnesses = take_columns(first, description.witness_columns);
+            first += description.witness_columns;
+            auto public_inputs = take_columns(first, description.public_input_columns);
+            first += description.public_input_columns;
+            std::vector<Column> constants;
+            std::vector<Column> selectors;
+            if (!private_only) {
+                constants = take_columns(first, description.constant_columns);
+                first += description.constant_columns;
+                selectors = take_columns(first, description.selector_columns);
+            }
+
+            return std::make_pair(
+                description,
+                AssignmentTable(
+                    typename AssignmentTable::private_table_type(std::move(witnesses)),
+                    typename AssignmentTable::public_table_type(
+                        std::move(public_inputs), std::move(constants), std::move(selectors)
+                    )
+                )
+            );
+        }
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_ASSIGNMENT_TABLE_FILE_HPP
@@ -0,0 +1,103 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef PROOF_GENERATOR_BATCH_HPP
+#define PROOF_GENERATOR_BATCH_HPP
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Single proof of a batch, all jobs of a batch share the circuit.
+        struct ProofJob {
+            boost::filesystem::path assignment_table_file_path;
+            boost::filesystem::path proof_file_path;
+            boost::filesystem::path json_file_path;
+        };
+
+        namespace detail {
+            inline std::optional<std::vector<ProofJob>> read_batch_manifest_file(const boost::filesystem::path& path) {
+                boost::property_tree::ptree manifest;
+                try {
+                    boost::property_tree::read_json(path.string(), manifest);
+                } catch (const boost::property_tree::json_parser_error& e) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to parse batch manifest " << path << ": " << e.what();
+                    return std::nullopt;
+                }
+
+                const boost::property_tree::ptree no_jobs;
+                std::vector<ProofJob> jobs;
+                for (const auto& [_, job] : manifest.get_child("jobs", no_jobs)) {
+                    auto table = job.get_optional<std::string>("assignment-table");
+                    auto proof = job.get_optional<std::string>("proof");
+                    if (!table || !proof) {
+                        BOOST_LOG_TRIVIAL(error) << "Each job of batch manifest " << path
+                                                 << " must contain 'assignment-table' and 'proof'";
+                        return std::nullopt;
+                    }
+                    boost::filesystem::path json = job.get<std::string>(
+                        "json",
+                        boost::filesystem::path(*proof).replace_extension(".json").string()
+                    );
+                    jobs.push_back({*table, *proof, json});
+                }
+                return jobs;
+            }
+
+            // Every *.tbl file under the directory is a job, proofs are written next to the tables.
+            inline std::vector<ProofJob> read_batch_directory(const boost::filesystem::path& path) {
+                std::vector<ProofJob> jobs;
+                for (const auto& entry : boost::filesystem::recursive_directory_iterator(path)) {
+                    if (!boost::filesystem::is_regular_file(entry) || entry.path().extension() != ".tbl") {
+                        continue;
+                    }
+                    const auto stem = entry.path().parent_path() / entry.path().stem();
+                    jobs.push_back({entry.path(), stem.string() + "_proof.bin", stem.string() + "_proof.json"});
+                }
+                std::sort(jobs.begin(), jobs.end(), [](const ProofJob& lhs, const ProofJob& rhs) {
+                    return lhs.assignment_table_file_path < rhs.assignment_table_file_path;
+                });
+                return jobs;
+            }
+        } // namespace detail
+
+        // Batch is either a directory with assignment tables or a JSON manifest of the form
+        //     {"jobs": [{"assignment-table": "a.tbl", "proof": "a.bin", "json": "a.json"}, ...]}
+        // where "json" is optional and defaults to the proof path with .json extension.
+        inline std::optional<std::vector<ProofJob>> read_batch(const boost::filesystem::path& path) {
+            std::optional<std::vector<ProofJob>> jobs = boost::filesystem::is_directory(path)
+                                                            ? detail::read_batch_directory(path)
+                                                            : detail::read_batch_manifest_file(path);
+            if (jobs && jobs->empty()) {
+                BOOST_LOG_TRIVIAL(error) << "Batch " << path << " contains no jobs";
+                return std::nullopt;
+            }
+            return jobs;
+        }
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_BATCH_HPP
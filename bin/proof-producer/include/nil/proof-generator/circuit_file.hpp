@@ -0,0 +1,154 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef PROOF_GENERATOR_CIRCUIT_FILE_HPP
+#define PROOF_GENERATOR_CIRCUIT_FILE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+
+#include <nil/marshalling/field_type.hpp>
+#include <nil/marshalling/status_type.hpp>
+
+#include <nil/crypto3/marshalling/zk/types/plonk/constraint_system.hpp>
+
+#include <nil/proof-generator/allocator.hpp>
+#include <nil/proof-generator/parallel.hpp>
+#include <nil/proof-generator/sectioned_file.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Sectioned circuit: the header section holds the number of parts, then every field of the marshalled
+        // constraint system (gates, copy constraints, lookup gates, lookup tables, ...) is a section of its own,
+        // so the parts are encoded and decoded concurrently.
+        namespace detail {
+            constexpr std::uint64_t circuit_header_section_id = 0;
+            constexpr std::uint64_t circuit_first_part_section_id = 1;
+
+            template<typename Endianness, typename ConstraintSystem>
+            using ConstraintSystemMarshalling = nil::crypto3::marshalling::types::plonk_constraint_system<
+                nil::marshalling::field_type<Endianness>, ConstraintSystem>;
+
+            template<typename Marshalling>
+            constexpr std::size_t circuit_parts_count =
+                std::tuple_size<typename Marshalling::value_type>::value;
+
+            template<typename Part>
+            bool encode_circuit_part(const Part& part, std::vector<std::uint8_t>& data) {
+                data.resize(part.length());
+                auto write_iter = data.begin();
+                return part.write(write_iter, data.size()) == nil::marshalling::status_type::success;
+            }
+
+            template<typename Part>
+            bool decode_circuit_part(const SectionedFile::SectionView& section, Part& part, AllocationArena& arena) {
+                const std::uint8_t* read_iter = section.data;
+                ArenaScope arena_scope(arena);
+                return part.read(read_iter, section.size) == nil::marshalling::status_type::success;
+            }
+
+            template<typename Marshalling, std::size_t... Indices>
+            bool encode_circuit_parts(
+                const Marshalling& marshalled_circuit,
+                std::vector<Section>& sections,
+                std::index_sequence<Indices...>
+            ) {
+                std::vector<std::function<bool()>> tasks = {[&]() {
+                    auto& section = sections[1 + Indices];
+                    section.id = circuit_first_part_section_id + Indices;
+                    return encode_circuit_part(std::get<Indices>(marshalled_circuit.value()), section.data);
+                }...};
+                return run_concurrently(tasks);
+            }
+
+            template<typename Marshalling, std::size_t... Indices>
+            bool decode_circuit_parts(
+                const SectionedFile& file,
+                Marshalling& marshalled_circuit,
+                std::vector<AllocationArena>& arenas,
+                std::index_sequence<Indices...>
+            ) {
+                std::vector<std::function<bool()>> tasks = {[&]() {
+                    const auto section = file.section(circuit_first_part_section_id + Indices);
+                    return section.has_value() &&
+                           decode_circuit_part(*section, std::get<Indices>(marshalled_circuit.value()), arenas[Indices]);
+                }...};
+                return run_concurrently(tasks);
+            }
+        } // namespace detail
+
+        template<typename Endianness, typename ConstraintSystem>
+        bool write_sectioned_circuit(const std::string& path, const ConstraintSystem& constraint_system) {
+            using Marshalling = detail::ConstraintSystemMarshalling<Endianness, ConstraintSystem>;
+            constexpr std::size_t parts_count = detail::circuit_parts_count<Marshalling>;
+
+            const auto marshalled_circuit =
+                nil::crypto3::marshalling::types::fill_plonk_constraint_system<Endianness, ConstraintSystem>(
+                    constraint_system
+                );
+
+            std::vector<Section> sections(1 + parts_count);
+            sections[0].id = detail::circuit_header_section_id;
+            sections[0].data.resize(8);
+            detail::store_le(sections[0].data.data(), parts_count, 8);
+            if (!detail::encode_circuit_parts(marshalled_circuit, sections, std::make_index_sequence<parts_count>())) {
+                BOOST_LOG_TRIVIAL(error) << "Encoding of circuit " << path << " failed";
+                return false;
+            }
+            return write_sectioned_file(path, SectionedFileKind::CIRCUIT, sections);
+        }
+
+        template<typename Endianness, typename ConstraintSystem>
+        std::optional<ConstraintSystem> read_sectioned_circuit(const std::string& path) {
+            using Marshalling = detail::ConstraintSystemMarshalling<Endianness, ConstraintSystem>;
+            constexpr std::size_t parts_count = detail::circuit_parts_count<Marshalling>;
+
+            const auto file = SectionedFile::open(path, SectionedFileKind::CIRCUIT);
+            if (!file.has_value()) {
+                return std::nullopt;
+            }
+
+            const auto header = file->section(detail::circuit_header_section_id);
+            if (!header.has_value() || header->size != 8 || detail::load_le(header->data, 8) != parts_count) {
+                BOOST_LOG_TRIVIAL(error) << "Circuit " << path << " has no valid header";
+                return std::nullopt;
+            }
+
+            // One arena per part, as parts are decoded on different threads. Declared first, so the marshalled
+            // structure allocated from them is destroyed before them.
+            std::vector<AllocationArena> arenas(parts_count);
+            Marshalling marshalled_circuit;
+            if (!detail::decode_circuit_parts(*file, marshalled_circuit, arenas, std::make_index_sequence<parts_count>())) {
+                BOOST_LOG_TRIVIAL(error) << "Circuit " << path << " has a missing or corrupted part";
+                return std::nullopt;
+            }
+            return nil::crypto3::marshalling::types::make_plonk_constraint_system<Endianness, ConstraintSystem>(
+                marshalled_circuit
+            );
+        }
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_CIRCUIT_FILE_HPP
@@ -0,0 +1,340 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_COMPRESSED_FILE_HPP
+#define PROOF_GENERATOR_COMPRESSED_FILE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+
+#ifdef PROOF_GENERATOR_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include <nil/proof-generator/parallel.hpp>
+#include <nil/proof-generator/sectioned_file.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Data compressed in independent blocks, stored as a sectioned file:
+        //     section 0: u64 uncompressed size | u64 block size | u64 codec
+        //     section i + 1: i-th block of block size bytes (the last one may be shorter), compressed
+        // The section index doubles as the block index, so blocks are compressed and decompressed in parallel.
+        // Sections are stored in the block order.
+        namespace detail {
+            enum class CompressionCodec : std::uint64_t {
+                ZSTD = 1
+            };
+
+            constexpr std::size_t compressed_file_header_fields_count = 3;
+            // Large enough for the codec to reach its ratio, small enough to keep every core busy
+            constexpr std::size_t compression_block_size = 16 << 20;
+        } // namespace detail
+
+        // Compresses data of a known size while it is being written. Bytes are gathered into blocks, every full
+        // block is compressed on its own thread and written to the file as soon as the blocks before it are, so
+        // at most max_blocks_in_flight blocks are held in memory instead of the whole data and its compressed copy.
+        class CompressedFileWriter {
+        public:
+            // Output iterator suitable for the marshalling write, see BufferedFileWriter::iterator.
+            class iterator {
+            public:
+                using iterator_category = std::output_iterator_tag;
+                using value_type = std::uint8_t;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = void;
+
+                explicit iterator(CompressedFileWriter& writer)
+                    : writer_(&writer) {
+                }
+
+                iterator& operator=(std::uint8_t value) {
+                    writer_->put(value);
+                    return *this;
+                }
+
+                iterator& operator*() {
+                    return *this;
+                }
+
+                iterator& operator++() {
+                    return *this;
+                }
+
+                iterator operator++(int) {
+                    return *this;
+                }
+
+            private:
+                CompressedFileWriter* writer_;
+            };
+
+            CompressedFileWriter(const CompressedFileWriter&) = delete;
+            CompressedFileWriter& operator=(const CompressedFileWriter&) = delete;
+            CompressedFileWriter(CompressedFileWriter&&) = default;
+
+            static std::optional<CompressedFileWriter> open(const std::string& path, std::size_t size, int level) {
+#ifdef PROOF_GENERATOR_WITH_ZSTD
+                const std::size_t blocks_count =
+                    (size + detail::compression_block_size - 1) / detail::compression_block_size;
+                auto file = SectionedFileWriter::open(path, SectionedFileKind::COMPRESSED, blocks_count + 1);
+                if (!file.has_value()) {
+                    return std::nullopt;
+                }
+                std::uint8_t header[detail::compressed_file_header_fields_count * 8];
+                detail::store_le(header, size, 8);
+                detail::store_le(header + 8, detail::compression_block_size, 8);
+                detail::store_le(header + 16, static_cast<std::uint64_t>(detail::CompressionCodec::ZSTD), 8);
+                file->add_section(0, header, sizeof(header));
+                return CompressedFileWriter(path, std::move(*file), size, level);
+#else
+                BOOST_LOG_TRIVIAL(error) << "Unable to write compressed file " << path
+                                         << ", proof producer is built without zstd";
+                return std::nullopt;
+#endif
+            }
+
+            iterator begin() {
+                return iterator(*this);
+            }
+
+            void put(std::uint8_t value) {
+                if (block_.empty()) {
+                    start_block();
+                }
+                block_[position_++] = value;
+                if (position_ == block_.size()) {
+                    submit_block();
+                }
+            }
+
+            void write(const std::uint8_t* data, std::size_t size) {
+                while (size > 0) {
+                    if (block_.empty()) {
+                        start_block();
+                    }
+                    const std::size_t chunk = std::min(size, block_.size() - position_);
+                    std::memcpy(block_.data() + position_, data, chunk);
+                    position_ += chunk;
+                    data += chunk;
+                    size -= chunk;
+                    if (position_ == block_.size()) {
+                        submit_block();
+                    }
+                }
+            }
+
+            // Compresses and writes the remaining blocks, returns false if compression or any write has failed or
+            // the amount of written data differs from the size given to open.
+            bool close() {
+                if (position_ != 0) {
+                    submit_block();
+                }
+                while (!in_flight_.empty()) {
+                    write_oldest_block();
+                }
+                if (written_ != size_) {
+                    BOOST_LOG_TRIVIAL(error) << "Compressed file " << path_ << " got " << written_
+                                             << " bytes instead of " << size_;
+                    failed_ = true;
+                }
+                return file_.close() && !failed_;
+            }
+
+        private:
+            CompressedFileWriter(const std::string& path, SectionedFileWriter file, std::size_t size, int level)
+                : path_(path)
+                , file_(std::move(file))
+                , size_(size)
+                , level_(level)
+                , max_blocks_in_flight_(threads_budget())
+                , written_(0)
+                , blocks_count_(0)
+                , failed_(false)
+                , position_(0) {
+            }
+
+            // Blocks are allocated on the first byte written to them. Every block but the last one is of the full
+            // block size, the last one ends with the data.
+            void start_block() {
+                const std::size_t remaining = size_ - std::min(written_, size_);
+                block_ = std::vector<std::uint8_t>(
+                    remaining == 0 ? detail::compression_block_size
+                                   : std::min(remaining, detail::compression_block_size));
+                position_ = 0;
+            }
+
+            void submit_block() {
+                block_.resize(position_);
+                written_ += block_.size();
+                if (written_ > size_) {
+                    // Blocks beyond the size given to open have no place in the index, close reports the error
+                    block_.clear();
+                    position_ = 0;
+                    return;
+                }
+                if (in_flight_.size() == max_blocks_in_flight_) {
+                    write_oldest_block();
+                }
+                in_flight_.push_back(std::async(std::launch::async, [block = std::move(block_), level = level_]() {
+                    return compress_block(block, level);
+                }));
+                block_.clear();
+                position_ = 0;
+            }
+
+            void write_oldest_block() {
+                const auto compressed = in_flight_.front().get();
+                in_flight_.pop_front();
+                ++blocks_count_;
+                if (!compressed.has_value()) {
+                    failed_ = true;
+                    return;
+                }
+                file_.add_section(blocks_count_, compressed->data(), compressed->size());
+            }
+
+            static std::optional<std::vector<std::uint8_t>> compress_block(
+                const std::vector<std::uint8_t>& block,
+                int level
+            ) {
+#ifdef PROOF_GENERATOR_WITH_ZSTD
+                std::vector<std::uint8_t> compressed(ZSTD_compressBound(block.size()));
+                const std::size_t compressed_size =
+                    ZSTD_compress(compressed.data(), compressed.size(), block.data(), block.size(), level);
+                if (ZSTD_isError(compressed_size)) {
+                    BOOST_LOG_TRIVIAL(error) << "Compression failed: " << ZSTD_getErrorName(compressed_size);
+                    return std::nullopt;
+                }
+                compressed.resize(compressed_size);
+                return compressed;
+#else
+                return std::nullopt;
+#endif
+            }
+
+            std::string path_;
+            SectionedFileWriter file_;
+            std::size_t size_;
+            int level_;
+            std::size_t max_blocks_in_flight_;
+            std::size_t written_;
+            std::uint64_t blocks_count_;
+            bool failed_;
+            std::vector<std::uint8_t> block_;
+            std::size_t position_;
+            std::deque<std::future<std::optional<std::vector<std::uint8_t>>>> in_flight_;
+        };
+
+        inline bool write_compressed_file(
+            const std::string& path,
+            const std::uint8_t* data,
+            std::size_t size,
+            int level
+        ) {
+            auto writer = CompressedFileWriter::open(path, size, level);
+            if (!writer.has_value()) {
+                return false;
+            }
+            writer->write(data, size);
+            return writer->close();
+        }
+
+        // Decompresses the whole data into memory, so reading costs its full uncompressed size on top of the
+        // mapped file. The header is validated against the stored blocks before anything is allocated.
+        inline std::optional<std::vector<std::uint8_t>> read_compressed_file(const std::string& path) {
+#ifdef PROOF_GENERATOR_WITH_ZSTD
+            const auto file = SectionedFile::open(path, SectionedFileKind::COMPRESSED);
+            if (!file.has_value()) {
+                return std::nullopt;
+            }
+            const auto header = file->section(0);
+            if (!header.has_value() || header->size != detail::compressed_file_header_fields_count * 8) {
+                BOOST_LOG_TRIVIAL(error) << "Compressed file " << path << " has no valid header";
+                return std::nullopt;
+            }
+            const std::uint64_t size = detail::load_le(header->data, 8);
+            const std::uint64_t block_size = detail::load_le(header->data + 8, 8);
+            if (detail::load_le(header->data + 16, 8) != static_cast<std::uint64_t>(detail::CompressionCodec::ZSTD) ||
+                block_size == 0 || block_size > detail::compression_block_size) {
+                BOOST_LOG_TRIVIAL(error) << "Compressed file " << path << " uses unsupported compression";
+                return std::nullopt;
+            }
+
+            // The size is only trusted once every block is present and declares its part of it
+            const std::uint64_t blocks_count = size / block_size + (size % block_size != 0 ? 1 : 0);
+            if (file->sections_count() != blocks_count + 1) {
+                BOOST_LOG_TRIVIAL(error) << "Compressed file " << path << " has " << file->sections_count() - 1
+                                         << " blocks instead of " << blocks_count;
+                return std::nullopt;
+            }
+            std::vector<SectionedFile::SectionView> blocks;
+            blocks.reserve(blocks_count);
+            for (std::uint64_t i = 0; i < blocks_count; ++i) {
+                const auto block = file->section(i + 1);
+                const std::uint64_t expected_size = std::min<std::uint64_t>(block_size, size - i * block_size);
+                if (!block.has_value() || ZSTD_getFrameContentSize(block->data, block->size) != expected_size) {
+                    BOOST_LOG_TRIVIAL(error) << "Compressed file " << path << " has missing or wrong block " << i;
+                    return std::nullopt;
+                }
+                blocks.push_back(*block);
+            }
+
+            std::vector<std::uint8_t> data(size);
+            std::vector<std::string> errors(blocks_count);
+            parallel_for(blocks_count, [&](std::size_t i) {
+                const auto& block = blocks[i];
+                const std::size_t offset = i * block_size;
+                const std::size_t expected_size = std::min<std::uint64_t>(block_size, size - offset);
+                const std::size_t decompressed_size =
+                    ZSTD_decompress(data.data() + offset, expected_size, block.data, block.size);
+                if (ZSTD_isError(decompressed_size)) {
+                    errors[i] = ZSTD_getErrorName(decompressed_size);
+                } else if (decompressed_size != expected_size) {
+                    errors[i] = "block " + std::to_string(i) + " has wrong size";
+                }
+            });
+            for (const auto& error : errors) {
+                if (!error.empty()) {
+                    BOOST_LOG_TRIVIAL(error) << "Decompression of " << path << " failed: " << error;
+                    return std::nullopt;
+                }
+            }
+            return data;
+#else
+            BOOST_LOG_TRIVIAL(error) << "Unable to read compressed file " << path
+                                     << ", proof producer is built without zstd";
+            return std::nullopt;
+#endif
+        }
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_COMPRESSED_FILE_HPP
@@ -17,15 +17,31 @@
 #ifndef PROOF_GENERATOR_FILE_OPERATIONS_HPP
 #define PROOF_GENERATOR_FILE_OPERATIONS_HPP
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <boost/filesystem.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <nil/crypto3/hash/algorithm/hash.hpp>
+#include <nil/crypto3/hash/sha2.hpp>
+
 namespace nil {
     namespace proof_generator {
         inline bool is_valid_path(const std::string& path) {
@@ -98,7 +114,7 @@ namespace nil {
             return file;
         }
 
-        std::optional<std::vector<std::uint8_t>> read_file_to_vector(const std::string& path) {
+        inline std::optional<std::vector<std::uint8_t>> read_file_to_vector(const std::string& path) {
 
             auto file = open_file<std::ifstream>(path, std::ios_base::in | std::ios::binary | std::ios::ate);
             if (!file.has_value()) {
@@ -120,7 +136,81 @@ namespace nil {
             return v;
         }
 
-        bool write_vector_to_file(const std::vector<std::uint8_t>& vector, const std::string& path) {
+        // Read-only mapping of a whole file. Pages are faulted in while the content is consumed, so the data
+        // is read from disk once and never copied into an intermediate buffer.
+        class MappedFile {
+        public:
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            MappedFile(MappedFile&& other) noexcept
+                : data_(std::exchange(other.data_, nullptr))
+                , size_(std::exchange(other.size_, 0)) {
+            }
+
+            ~MappedFile() {
+                if (data_ != nullptr) {
+                    munmap(data_, size_);
+                }
+            }
+
+            const std::uint8_t* data() const {
+                return static_cast<const std::uint8_t*>(data_);
+            }
+
+            std::size_t size() const {
+                return size_;
+            }
+
+            static std::optional<MappedFile> open(const std::string& path) {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to open file: " << path;
+                    return std::nullopt;
+                }
+
+                struct stat file_stat;
+                if (fstat(fd, &file_stat) != 0) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to get size of file: " << path;
+                    ::close(fd);
+                    return std::nullopt;
+                }
+
+                const std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+                if (size == 0) {
+                    ::close(fd);
+                    return MappedFile(nullptr, 0);
+                }
+
+                void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                // The mapping keeps its own reference to the file
+                ::close(fd);
+                if (data == MAP_FAILED) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to map file: " << path;
+                    return std::nullopt;
+                }
+
+                // Both are hints only: the content is decoded front to back, and large page cache pages
+                // reduce TLB pressure on multi-GB inputs where the kernel supports them.
+                madvise(data, size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+                madvise(data, size, MADV_HUGEPAGE);
+#endif
+
+                return MappedFile(data, size);
+            }
+
+        private:
+            MappedFile(void* data, std::size_t size)
+                : data_(data)
+                , size_(size) {
+            }
+
+            void* data_;
+            std::size_t size_;
+        };
+
+        inline bool write_vector_to_file(const std::vector<std::uint8_t>& vector, const std::string& path) {
 
             auto file = open_file<std::ofstream>(path, std::ios_base::out | std::ios_base::binary);
             if (!file.has_value()) {
@@ -138,45 +228,114 @@ namespace nil {
             return true;
         }
 
+        namespace detail {
+            struct hex_tables {
+                std::array<std::array<char, 2>, 256> encode;
+                std::array<std::int8_t, 256> decode;
+
+                constexpr hex_tables() : encode(), decode() {
+                    constexpr char digits[] = "0123456789abcdef";
+                    for (std::size_t i = 0; i < 256; ++i) {
+                        encode[i] = {digits[i >> 4], digits[i & 0xf]};
+                        decode[i] = -1;
+                    }
+                    for (std::size_t i = 0; i < 10; ++i) {
+                        decode['0' + i] = static_cast<std::int8_t>(i);
+                    }
+                    for (std::size_t i = 0; i < 6; ++i) {
+                        decode['a' + i] = static_cast<std::int8_t>(10 + i);
+                        decode['A' + i] = static_cast<std::int8_t>(10 + i);
+                    }
+                }
+            };
+
+            inline constexpr hex_tables hex_lookup;
+
+            // Writes 2 * size characters to out.
+            inline void hex_encode(const std::uint8_t* data, std::size_t size, char* out) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    std::memcpy(out + 2 * i, hex_lookup.encode[data[i]].data(), 2);
+                }
+            }
+
+            // Reads 2 * size characters from in, returns false on a non-hex character.
+            inline bool hex_decode(const char* in, std::size_t size, std::uint8_t* out) {
+                std::int8_t invalid = 0;
+                for (std::size_t i = 0; i < size; ++i) {
+                    const std::int8_t high = hex_lookup.decode[static_cast<std::uint8_t>(in[2 * i])];
+                    const std::int8_t low = hex_lookup.decode[static_cast<std::uint8_t>(in[2 * i + 1])];
+                    // Branchless validity check, any negative value sets the sign bit
+                    invalid |= high | low;
+                    out[i] = static_cast<std::uint8_t>(((high & 0xf) << 4) | (low & 0xf));
+                }
+                return invalid >= 0;
+            }
+        } // namespace detail
+
         // HEX data format is not efficient, we will remove it later
-        std::optional<std::vector<std::uint8_t>> read_hex_file_to_vector(const std::string& path) {
-            auto file = open_file<std::ifstream>(path, std::ios_base::in);
+        inline std::optional<std::vector<std::uint8_t>> read_hex_file_to_vector(const std::string& path) {
+            auto file = open_file<std::ifstream>(path, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
             if (!file.has_value()) {
                 return std::nullopt;
             }
 
             std::ifstream& stream = file.value();
-            std::vector<uint8_t> result;
-            std::string line;
-            while (std::getline(stream, line)) {
-                if (line.rfind("0x", 0) == 0 && line.length() >= 3) {
-                    for (size_t i = 2; i < line.length(); i += 2) {
-                        std::string hex_string = line.substr(i, 2);
-                        uint8_t byte = static_cast<uint8_t>(std::stoul(hex_string, nullptr, 16));
-                        result.push_back(byte);
-                    }
-                } else {
+            std::string content(static_cast<std::size_t>(stream.tellg()), '\0');
+            stream.seekg(0, std::ios::beg);
+            stream.read(content.data(), content.size());
+            if (stream.fail()) {
+                BOOST_LOG_TRIVIAL(error) << "Error occurred during reading file " << path;
+                return std::nullopt;
+            }
+
+            std::vector<std::uint8_t> result;
+            result.reserve(content.size() / 2);
+            std::size_t line_begin = 0;
+            while (line_begin < content.size()) {
+                std::size_t line_end = content.find('\n', line_begin);
+                if (line_end == std::string::npos) {
+                    line_end = content.size();
+                }
+                std::size_t digits_end = line_end;
+                if (digits_end > line_begin && content[digits_end - 1] == '\r') {
+                    --digits_end;
+                }
+
+                const std::size_t digits_begin = line_begin + 2;
+                if (digits_end < digits_begin + 1 || content.compare(line_begin, 2, "0x") != 0 ||
+                    (digits_end - digits_begin) % 2 != 0) {
+                    BOOST_LOG_TRIVIAL(error) << "File contains non-hex string";
+                    return std::nullopt;
+                }
+
+                const std::size_t bytes = (digits_end - digits_begin) / 2;
+                result.resize(result.size() + bytes);
+                if (!detail::hex_decode(content.data() + digits_begin, bytes, result.data() + result.size() - bytes)) {
                     BOOST_LOG_TRIVIAL(error) << "File contains non-hex string";
                     return std::nullopt;
                 }
+                line_begin = line_end + 1;
             }
 
             return result;
         }
 
-        bool write_vector_to_hex_file(const std::vector<std::uint8_t>& vector, const std::string& path) {
-            auto file = open_file<std::ofstream>(path, std::ios_base::out);
+        inline bool write_vector_to_hex_file(const std::vector<std::uint8_t>& vector, const std::string& path) {
+            auto file = open_file<std::ofstream>(path, std::ios_base::out | std::ios_base::binary);
             if (!file.has_value()) {
                 return false;
             }
 
             std::ofstream& stream = file.value();
 
-            stream << "0x" << std::hex;
-            for (auto it = vector.cbegin(); it != vector.cend(); ++it) {
-                stream << std::setfill('0') << std::setw(2) << std::right << int(*it);
+            constexpr std::size_t chunk_size = 1 << 20;
+            std::vector<char> buffer(2 * std::min(chunk_size, vector.size()));
+            stream << "0x";
+            for (std::size_t offset = 0; offset < vector.size(); offset += chunk_size) {
+                const std::size_t size = std::min(chunk_size, vector.size() - offset);
+                detail::hex_encode(vector.data() + offset, size, buffer.data());
+                stream.write(buffer.data(), 2 * size);
             }
-            stream << std::dec;
 
             if (stream.fail()) {
                 BOOST_LOG_TRIVIAL(error) << "Error occurred during writing to file " << path;
@@ -186,6 +345,244 @@ namespace nil {
             return true;
         }
 
+        // Sequential file writer with a fixed-size buffer, so the encoded content is never kept in memory as a
+        // whole. In hex mode the bytes are hex-encoded chunk by chunk in the format of write_vector_to_hex_file.
+        class BufferedFileWriter {
+        public:
+            // Output iterator suitable for the marshalling write, similar to std::back_insert_iterator.
+            class iterator {
+            public:
+                using iterator_category = std::output_iterator_tag;
+                using value_type = std::uint8_t;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = void;
+
+                explicit iterator(BufferedFileWriter& writer)
+                    : writer_(&writer) {
+                }
+
+                iterator& operator=(std::uint8_t value) {
+                    writer_->put(value);
+                    return *this;
+                }
+
+                iterator& operator*() {
+                    return *this;
+                }
+
+                iterator& operator++() {
+                    return *this;
+                }
+
+                iterator operator++(int) {
+                    return *this;
+                }
+
+            private:
+                BufferedFileWriter* writer_;
+            };
+
+            static constexpr std::size_t buffer_size = 4 << 20;
+
+            BufferedFileWriter(const BufferedFileWriter&) = delete;
+            BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+            BufferedFileWriter(BufferedFileWriter&& other) noexcept
+                : path_(std::move(other.path_))
+                , fd_(std::exchange(other.fd_, -1))
+                , hex_(other.hex_)
+                , failed_(other.failed_)
+                , buffer_(std::move(other.buffer_))
+                , position_(other.position_)
+                , flushed_(other.flushed_)
+                , hex_buffer_(std::move(other.hex_buffer_)) {
+            }
+
+            ~BufferedFileWriter() {
+                if (fd_ >= 0) {
+                    ::close(fd_);
+                }
+            }
+
+            static std::optional<BufferedFileWriter> open(const std::string& path, bool hex = false) {
+                int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+                if (fd < 0) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to open file: " << path;
+                    return std::nullopt;
+                }
+
+                BufferedFileWriter writer(path, fd, hex);
+                if (hex) {
+                    writer.write_raw("0x", 2);
+                }
+                return writer;
+            }
+
+            iterator begin() {
+                return iterator(*this);
+            }
+
+            void put(std::uint8_t value) {
+                buffer_[position_++] = value;
+                if (position_ == buffer_.size()) {
+                    flush();
+                }
+            }
+
+            void write(const std::uint8_t* data, std::size_t size) {
+                if (!hex_ && size >= buffer_.size()) {
+                    // Large blocks go to the file as is, without copying them through the buffer
+                    flush();
+                    write_raw(reinterpret_cast<const char*>(data), size);
+                    flushed_ += size;
+                    return;
+                }
+                while (size > 0) {
+                    const std::size_t chunk = std::min(size, buffer_.size() - position_);
+                    std::memcpy(buffer_.data() + position_, data, chunk);
+                    position_ += chunk;
+                    data += chunk;
+                    size -= chunk;
+                    if (position_ == buffer_.size()) {
+                        flush();
+                    }
+                }
+            }
+
+            // Bytes written so far, before the hex encoding.
+            std::uint64_t size() const {
+                return flushed_ + position_;
+            }
+
+            // Flushes the remaining data and closes the file, returns false if any write has failed.
+            bool close() {
+                flush();
+                if (fd_ >= 0 && ::close(fd_) != 0) {
+                    failed_ = true;
+                }
+                fd_ = -1;
+                if (failed_) {
+                    BOOST_LOG_TRIVIAL(error) << "Error occurred during writing to file " << path_;
+                }
+                return !failed_;
+            }
+
+        private:
+            BufferedFileWriter(const std::string& path, int fd, bool hex)
+                : path_(path)
+                , fd_(fd)
+                , hex_(hex)
+                , failed_(false)
+                , buffer_(buffer_size)
+                , position_(0)
+                , flushed_(0)
+                , hex_buffer_(hex ? 2 * buffer_size : 0) {
+            }
+
+            void flush() {
+                if (position_ == 0) {
+                    return;
+                }
+                if (hex_) {
+                    detail::hex_encode(buffer_.data(), position_, hex_buffer_.data());
+                    write_raw(hex_buffer_.data(), 2 * position_);
+                } else {
+                    write_raw(reinterpret_cast<const char*>(buffer_.data()), position_);
+                }
+                flushed_ += position_;
+                position_ = 0;
+            }
+
+            void write_raw(const char* data, std::size_t size) {
+                while (!failed_ && size > 0) {
+                    const ssize_t written = ::write(fd_, data, size);
+                    if (written < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        failed_ = true;
+                        break;
+                    }
+                    data += written;
+                    size -= static_cast<std::size_t>(written);
+                }
+            }
+
+            std::string path_;
+            int fd_;
+            bool hex_;
+            bool failed_;
+            std::vector<std::uint8_t> buffer_;
+            std::size_t position_;
+            std::uint64_t flushed_;
+            std::vector<char> hex_buffer_;
+        };
+
+        // Incremental SHA-256, used where content identifies stored results, like preprocessing cache entries, so
+        // that different inputs never share a result.
+        class ContentDigest {
+        public:
+            using hash_type = nil::crypto3::hashes::sha2<256>;
+
+            void update(const void* data, std::size_t size) {
+                const auto* bytes = static_cast<const std::uint8_t*>(data);
+                nil::crypto3::hash<hash_type>(bytes, bytes + size, accumulator_);
+            }
+
+            void update(std::uint64_t value) {
+                std::uint8_t bytes[8];
+                for (std::size_t i = 0; i < 8; ++i) {
+                    bytes[i] = static_cast<std::uint8_t>(value >> (8 * i));
+                }
+                update(bytes, sizeof(bytes));
+            }
+
+            void update(const std::string& value) {
+                update(value.size());
+                update(value.data(), value.size());
+            }
+
+            // Lowercase hex of the digest
+            std::string hex_digest() {
+                const typename hash_type::digest_type digest =
+                    nil::crypto3::accumulators::extract::hash<hash_type>(accumulator_);
+                static const char digits[] = "0123456789abcdef";
+                std::string result;
+                result.reserve(2 * digest.size());
+                for (std::uint8_t byte : digest) {
+                    result.push_back(digits[byte >> 4]);
+                    result.push_back(digits[byte & 0xf]);
+                }
+                return result;
+            }
+
+        private:
+            nil::crypto3::accumulator_set<hash_type> accumulator_;
+        };
+
+        // SHA-256 of the whole file content in hex, see ContentDigest.
+        inline std::optional<std::string> digest_file_content(const std::string& path) {
+            auto file = open_file<std::ifstream>(path, std::ios_base::in | std::ios_base::binary);
+            if (!file.has_value()) {
+                return std::nullopt;
+            }
+
+            std::ifstream& stream = file.value();
+            std::vector<char> buffer(1 << 20);
+            ContentDigest digest;
+            while (stream) {
+                stream.read(buffer.data(), buffer.size());
+                digest.update(buffer.data(), static_cast<std::size_t>(stream.gcount()));
+            }
+
+            if (stream.bad()) {
+                BOOST_LOG_TRIVIAL(error) << "Error occurred during reading file " << path;
+                return std::nullopt;
+            }
+            return digest.hex_digest();
+        }
+
     } // namespace proof_generator
 } // namespace nil
 
@@ -0,0 +1,325 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef PROOF_GENERATOR_METRICS_HPP
+#define PROOF_GENERATOR_METRICS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <nil/proof-generator/allocator.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Resource usage of the process at some moment, all values are process-wide.
+        struct ResourceUsage {
+            std::chrono::steady_clock::time_point wall_time;
+            double cpu_seconds = 0;
+            std::uint64_t peak_rss_bytes = 0;
+            // Bytes passed through read/write syscalls, and bytes actually fetched from/sent to storage.
+            std::uint64_t bytes_read = 0;
+            std::uint64_t bytes_written = 0;
+            std::uint64_t storage_bytes_read = 0;
+            std::uint64_t storage_bytes_written = 0;
+            // Calls of operator new, including the ones served by allocation arenas
+            std::uint64_t allocations = 0;
+
+            static ResourceUsage current() {
+                ResourceUsage usage;
+                usage.wall_time = std::chrono::steady_clock::now();
+
+                timespec cpu_time;
+                if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_time) == 0) {
+                    usage.cpu_seconds = cpu_time.tv_sec + cpu_time.tv_nsec * 1e-9;
+                }
+
+                rusage resources;
+                if (getrusage(RUSAGE_SELF, &resources) == 0) {
+                    // Linux reports kilobytes
+                    usage.peak_rss_bytes = static_cast<std::uint64_t>(resources.ru_maxrss) * 1024;
+                }
+                usage.allocations = allocator_statistics().allocations;
+
+                std::ifstream io("/proc/self/io");
+                std::string key;
+                std::uint64_t value;
+                while (io >> key >> value) {
+                    if (key == "rchar:") {
+                        usage.bytes_read = value;
+                    } else if (key == "wchar:") {
+                        usage.bytes_written = value;
+                    } else if (key == "read_bytes:") {
+                        usage.storage_bytes_read = value;
+                    } else if (key == "write_bytes:") {
+                        usage.storage_bytes_written = value;
+                    }
+                }
+                return usage;
+            }
+        };
+
+        namespace detail {
+            // High-water mark of RSS since the process start or the last reset_peak_rss, 0 if unavailable.
+            inline std::uint64_t read_peak_rss() {
+                std::ifstream status("/proc/self/status");
+                std::string key;
+                while (status >> key) {
+                    if (key == "VmHWM:") {
+                        std::uint64_t kilobytes = 0;
+                        status >> kilobytes;
+                        return kilobytes * 1024;
+                    }
+                    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                }
+                return 0;
+            }
+
+            // Makes the high-water mark equal to the current RSS, returns false if the kernel does not support it.
+            inline bool reset_peak_rss() {
+                std::ofstream clear_refs("/proc/self/clear_refs");
+                clear_refs << "5";
+                clear_refs.flush();
+                return clear_refs.good();
+            }
+        } // namespace detail
+
+        // Collects per-phase resource usage when enabled with --metrics-out, does nothing otherwise. Phases with
+        // the same name are accumulated. Usage is measured for the whole process, so phases running concurrently
+        // are accounted in each of them. Peak RSS is the peak reached during the phase where the kernel allows to
+        // reset the high-water mark, and the process peak otherwise.
+        class Metrics {
+        public:
+            struct PhaseStatistics {
+                std::string name;
+                std::size_t count = 0;
+                double wall_seconds = 0;
+                double cpu_seconds = 0;
+                std::uint64_t peak_rss_bytes = 0;
+                std::uint64_t bytes_read = 0;
+                std::uint64_t bytes_written = 0;
+                std::uint64_t storage_bytes_read = 0;
+                std::uint64_t storage_bytes_written = 0;
+                std::uint64_t allocations = 0;
+            };
+
+            // Measures the phase from construction until finish() or destruction.
+            class Phase {
+            public:
+                Phase(Metrics* metrics, std::string name)
+                    : metrics_(metrics)
+                    , name_(std::move(name)) {
+                    if (metrics_) {
+                        start_ = ResourceUsage::current();
+                        metrics_->begin_peak_tracking(&peak_rss_);
+                    }
+                }
+
+                Phase(const Phase&) = delete;
+                Phase& operator=(const Phase&) = delete;
+
+                ~Phase() {
+                    finish();
+                }
+
+                void finish() {
+                    if (metrics_) {
+                        metrics_->end_peak_tracking(&peak_rss_);
+                        ResourceUsage end = ResourceUsage::current();
+                        if (peak_rss_ != 0) {
+                            end.peak_rss_bytes = peak_rss_;
+                        }
+                        metrics_->record(name_, start_, end);
+                        metrics_ = nullptr;
+                    }
+                }
+
+            private:
+                Metrics* metrics_;
+                std::string name_;
+                ResourceUsage start_;
+                // Updated by Metrics while the phase is active, the phase is never moved since construction
+                std::uint64_t peak_rss_ = 0;
+            };
+
+            static Metrics& instance() {
+                static Metrics metrics;
+                return metrics;
+            }
+
+            void enable() {
+                // Allocations are counted per phase
+                enable_allocation_accounting();
+                enabled_ = true;
+                start_ = ResourceUsage::current();
+            }
+
+            bool enabled() const {
+                return enabled_;
+            }
+
+            Phase start_phase(std::string name) {
+                return Phase(enabled_ ? this : nullptr, std::move(name));
+            }
+
+            std::vector<PhaseStatistics> phases() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return phases_;
+            }
+
+            // Forgets recorded phases, so the same process can report independent runs.
+            void reset() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                phases_.clear();
+            }
+
+            // Phase names are plain identifiers, so no escaping is needed
+            static void write_phase(std::ostream& out, const PhaseStatistics& phase) {
+                out << "{\"name\": \"" << phase.name << "\""
+                    << ", \"count\": " << phase.count
+                    << ", \"wall_time_s\": " << phase.wall_seconds
+                    << ", \"cpu_time_s\": " << phase.cpu_seconds
+                    << ", \"peak_rss_bytes\": " << phase.peak_rss_bytes
+                    << ", \"bytes_read\": " << phase.bytes_read
+                    << ", \"bytes_written\": " << phase.bytes_written
+                    << ", \"storage_bytes_read\": " << phase.storage_bytes_read
+                    << ", \"storage_bytes_written\": " << phase.storage_bytes_written
+                    << ", \"allocations\": " << phase.allocations << "}";
+            }
+
+            bool write_report(const boost::filesystem::path& report_file) const {
+                BOOST_LOG_TRIVIAL(info) << "Writing metrics report to " << report_file;
+                std::ofstream out(report_file.string());
+                if (!out.is_open()) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to open file: " << report_file;
+                    return false;
+                }
+
+                out << std::setprecision(9) << "{\n  \"phases\": [";
+                const auto phases_statistics = phases();
+                for (std::size_t i = 0; i < phases_statistics.size(); ++i) {
+                    out << (i == 0 ? "\n    " : ",\n    ");
+                    write_phase(out, phases_statistics[i]);
+                }
+
+                PhaseStatistics total{"total"};
+                ResourceUsage end = ResourceUsage::current();
+                {
+                    // Resets of the high-water mark are seen by getrusage too
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    end.peak_rss_bytes = std::max({end.peak_rss_bytes, process_peak_rss_, detail::read_peak_rss()});
+                }
+                accumulate(total, start_, end);
+                out << "\n  ],\n  \"total\": ";
+                write_phase(out, total);
+                out << "\n}\n";
+
+                if (out.fail()) {
+                    BOOST_LOG_TRIVIAL(error) << "Error occurred during writing to file " << report_file;
+                    return false;
+                }
+                return true;
+            }
+
+        private:
+            Metrics() = default;
+
+            static void accumulate(PhaseStatistics& phase, const ResourceUsage& start, const ResourceUsage& end) {
+                phase.count += 1;
+                phase.wall_seconds += std::chrono::duration<double>(end.wall_time - start.wall_time).count();
+                phase.cpu_seconds += end.cpu_seconds - start.cpu_seconds;
+                phase.peak_rss_bytes = std::max(phase.peak_rss_bytes, end.peak_rss_bytes);
+                phase.bytes_read += end.bytes_read - start.bytes_read;
+                phase.bytes_written += end.bytes_written - start.bytes_written;
+                phase.storage_bytes_read += end.storage_bytes_read - start.storage_bytes_read;
+                phase.storage_bytes_written += end.storage_bytes_written - start.storage_bytes_written;
+                phase.allocations += end.allocations - start.allocations;
+            }
+
+            // High-water mark is process-wide, so before it is reset the peak reached so far is credited to every
+            // active phase.
+            void collect_peak_rss() {
+                const std::uint64_t peak = detail::read_peak_rss();
+                process_peak_rss_ = std::max(process_peak_rss_, peak);
+                for (std::uint64_t* active_peak : active_peaks_) {
+                    *active_peak = std::max(*active_peak, peak);
+                }
+                peak_rss_resettable_ = detail::reset_peak_rss();
+            }
+
+            void begin_peak_tracking(std::uint64_t* peak) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!peak_rss_resettable_) {
+                    return;
+                }
+                collect_peak_rss();
+                active_peaks_.push_back(peak);
+            }
+
+            void end_peak_tracking(std::uint64_t* peak) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = std::find(active_peaks_.begin(), active_peaks_.end(), peak);
+                if (it == active_peaks_.end()) {
+                    return;
+                }
+                collect_peak_rss();
+                active_peaks_.erase(it);
+                if (!peak_rss_resettable_) {
+                    // Process peak is reported instead
+                    *peak = 0;
+                }
+            }
+
+            void record(const std::string& name, const ResourceUsage& start, const ResourceUsage& end) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = std::find_if(phases_.begin(), phases_.end(), [&name](const PhaseStatistics& phase) {
+                    return phase.name == name;
+                });
+                if (it == phases_.end()) {
+                    phases_.push_back({name});
+                    it = std::prev(phases_.end());
+                }
+                accumulate(*it, start, end);
+            }
+
+            bool enabled_ = false;
+            ResourceUsage start_;
+            mutable std::mutex mutex_;
+            std::vector<PhaseStatistics> phases_;
+            bool peak_rss_resettable_ = true;
+            std::uint64_t process_peak_rss_ = 0;
+            std::vector<std::uint64_t*> active_peaks_;
+        };
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_METRICS_HPP
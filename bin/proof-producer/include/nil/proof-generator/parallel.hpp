@@ -0,0 +1,186 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_PARALLEL_HPP
+#define PROOF_GENERATOR_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Number of CPUs the process may run on. Scheduler workers are pinned to their pool before they start, so
+        // in a worker this is the size of its pool rather than of the machine.
+        inline std::size_t threads_budget() {
+            cpu_set_t available;
+            CPU_ZERO(&available);
+            if (sched_getaffinity(0, sizeof(available), &available) == 0) {
+                return std::max(1, CPU_COUNT(&available));
+            }
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // Calls f(i) for every i in [0, count) on up to threads_budget threads, indices are taken one at a time so
+        // uneven items are balanced. The first exception thrown by f is rethrown after all threads finish.
+        template<typename F>
+        void parallel_for(std::size_t count, F f) {
+            const std::size_t threads_count = std::min(count, threads_budget());
+            if (threads_count <= 1) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    f(i);
+                }
+                return;
+            }
+
+            std::atomic<std::size_t> next_index(0);
+            std::exception_ptr error;
+            std::mutex error_mutex;
+            auto worker = [&]() {
+                for (std::size_t i = next_index++; i < count; i = next_index++) {
+                    try {
+                        f(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        // Skip the remaining items
+                        next_index = count;
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(threads_count - 1);
+            for (std::size_t i = 1; i < threads_count; ++i) {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // Runs the tasks on their own threads and waits for all of them, true if every task succeeded. Meant for a
+        // few coarse tasks like writing independent files, so the number of threads is the number of tasks. The
+        // first exception thrown by a task is rethrown after all tasks finish.
+        inline bool run_concurrently(const std::vector<std::function<bool()>>& tasks) {
+            std::vector<std::future<bool>> results;
+            results.reserve(tasks.size());
+            for (const auto& task : tasks) {
+                results.push_back(std::async(std::launch::async, task));
+            }
+
+            bool result = true;
+            std::exception_ptr error;
+            for (auto& task_result : results) {
+                try {
+                    result = task_result.get() && result;
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return result;
+        }
+
+        // Tasks with dependencies between them. Each task starts on its own thread as soon as all its dependencies
+        // have succeeded, and is skipped if any of them failed, so independent stages like reading of separate
+        // input files overlap. Dependencies are given by ids returned from add, so the graph can't have cycles.
+        class TaskGraph {
+        public:
+            using TaskId = std::size_t;
+
+            TaskId add(std::function<bool()> task, std::vector<TaskId> dependencies = {}) {
+                for (TaskId dependency : dependencies) {
+                    if (dependency >= tasks_.size()) {
+                        throw std::invalid_argument("Task depends on a task which is not added yet");
+                    }
+                }
+                tasks_.push_back({std::move(task), std::move(dependencies)});
+                return tasks_.size() - 1;
+            }
+
+            // True if every task succeeded. The first exception thrown by a task is rethrown after all tasks finish.
+            bool run() {
+                std::vector<std::shared_future<bool>> results;
+                results.reserve(tasks_.size());
+                for (const auto& task : tasks_) {
+                    std::vector<std::shared_future<bool>> dependencies;
+                    for (TaskId dependency : task.dependencies) {
+                        dependencies.push_back(results[dependency]);
+                    }
+                    results.push_back(
+                        std::async(std::launch::async, [&task, dependencies]() {
+                            bool dependencies_succeeded = true;
+                            for (const auto& dependency : dependencies) {
+                                dependencies_succeeded = dependency.get() && dependencies_succeeded;
+                            }
+                            return dependencies_succeeded && task.function();
+                        }).share()
+                    );
+                }
+
+                bool result = true;
+                std::exception_ptr error;
+                for (auto& task_result : results) {
+                    try {
+                        result = task_result.get() && result;
+                    } catch (...) {
+                        result = false;
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                }
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                return result;
+            }
+
+        private:
+            struct Task {
+                std::function<bool()> function;
+                std::vector<TaskId> dependencies;
+            };
+
+            std::vector<Task> tasks_;
+        };
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_PARALLEL_HPP
@@ -0,0 +1,219 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_PREPROCESSING_CACHE_HPP
+#define PROOF_GENERATOR_PREPROCESSING_CACHE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Directory of preprocessed artifacts, one subdirectory per key. Entries are published by renaming a
+        // complete temporary directory, so concurrent processes never see a partial entry. Modification time of
+        // an entry is its last use; least recently used entries are removed once the cache exceeds its size limit.
+        // Every entry has a manifest with the fingerprint of its inputs and the sizes of its files, which are checked
+        // before the entry is used.
+        class PreprocessingCache {
+        public:
+            // Cached file name and the path it is copied from or to.
+            using Artifact = std::pair<std::string, boost::filesystem::path>;
+
+            struct Key {
+                // Digest of the inputs, names the entry
+                std::string digest;
+                // Single-line description of the inputs other than their content, like parameters and file sizes
+                std::string fingerprint;
+            };
+
+            // Zero size limit means no limit.
+            PreprocessingCache(boost::filesystem::path directory, std::uint64_t size_limit)
+                : directory_(std::move(directory))
+                , size_limit_(size_limit) {
+            }
+
+            // Copies cached artifacts to their paths, returns false if the entry is missing, incomplete or made
+            // from other inputs.
+            bool fetch(const Key& key, const std::vector<Artifact>& artifacts) const {
+                const auto entry = directory_ / key.digest;
+                boost::system::error_code ec;
+                if (!boost::filesystem::is_directory(entry, ec)) {
+                    return false;
+                }
+                if (!check_manifest(entry, key, artifacts)) {
+                    return false;
+                }
+                for (const auto& [name, path] : artifacts) {
+                    boost::filesystem::copy_file(
+                        entry / name, path, boost::filesystem::copy_options::overwrite_existing, ec
+                    );
+                    if (ec) {
+                        // Could be evicted by another process in the meantime
+                        BOOST_LOG_TRIVIAL(warning) << "Unable to fetch " << name << " from cache entry "
+                                                   << entry << ": " << ec.message();
+                        return false;
+                    }
+                }
+                boost::filesystem::last_write_time(entry, std::time(nullptr), ec);
+                BOOST_LOG_TRIVIAL(info) << "Artifacts are taken from cache entry " << entry;
+                return true;
+            }
+
+            // Failures are only logged, the cache is never required for the result.
+            void store(const Key& key, const std::vector<Artifact>& artifacts) const {
+                const auto entry = directory_ / key.digest;
+                const auto temporary_entry = directory_ / (key.digest + ".tmp." + std::to_string(getpid()));
+                boost::system::error_code ec;
+                boost::filesystem::create_directories(temporary_entry, ec);
+                std::ofstream manifest;
+                if (!ec) {
+                    manifest.open((temporary_entry / manifest_name).string());
+                    manifest << key.fingerprint << "\n";
+                }
+                for (const auto& [name, path] : artifacts) {
+                    if (ec) {
+                        break;
+                    }
+                    boost::filesystem::copy_file(
+                        path, temporary_entry / name, boost::filesystem::copy_options::overwrite_existing, ec
+                    );
+                    if (!ec) {
+                        manifest << name << " " << boost::filesystem::file_size(temporary_entry / name, ec) << "\n";
+                    }
+                }
+                manifest.close();
+                if (!ec && manifest.fail()) {
+                    ec = boost::system::errc::make_error_code(boost::system::errc::io_error);
+                }
+                if (!ec) {
+                    // Fails if another process has published the same entry first, which is just as good
+                    boost::filesystem::rename(temporary_entry, entry, ec);
+                }
+                if (ec) {
+                    BOOST_LOG_TRIVIAL(warning) << "Unable to store artifacts in cache entry " << entry << ": "
+                                               << ec.message();
+                    boost::filesystem::remove_all(temporary_entry, ec);
+                    return;
+                }
+                BOOST_LOG_TRIVIAL(info) << "Artifacts are stored in cache entry " << entry;
+                evict(key.digest);
+            }
+
+        private:
+            static constexpr const char* manifest_name = "manifest";
+
+            bool check_manifest(
+                const boost::filesystem::path& entry,
+                const Key& key,
+                const std::vector<Artifact>& artifacts
+            ) const {
+                std::ifstream manifest((entry / manifest_name).string());
+                std::string fingerprint;
+                if (!std::getline(manifest, fingerprint) || fingerprint != key.fingerprint) {
+                    BOOST_LOG_TRIVIAL(warning) << "Cache entry " << entry << " was made from other inputs, ignoring it";
+                    return false;
+                }
+                std::map<std::string, std::uint64_t> sizes;
+                std::string name;
+                std::uint64_t size;
+                while (manifest >> name >> size) {
+                    sizes[name] = size;
+                }
+                for (const auto& artifact : artifacts) {
+                    boost::system::error_code ec;
+                    const auto it = sizes.find(artifact.first);
+                    if (it == sizes.end() || boost::filesystem::file_size(entry / artifact.first, ec) != it->second ||
+                        ec) {
+                        BOOST_LOG_TRIVIAL(warning) << "File " << artifact.first << " of cache entry " << entry
+                                                   << " is missing or has a wrong size, ignoring the entry";
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            struct Entry {
+                boost::filesystem::path path;
+                std::time_t last_use;
+                std::uint64_t size;
+            };
+
+            void evict(const std::string& keep_key) const {
+                if (size_limit_ == 0) {
+                    return;
+                }
+
+                boost::system::error_code ec;
+                std::vector<Entry> entries;
+                std::uint64_t total_size = 0;
+                for (boost::filesystem::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+                    const auto& path = it->path();
+                    // Entries can disappear at any moment because of other processes, such errors are skipped
+                    boost::system::error_code entry_ec;
+                    if (!boost::filesystem::is_directory(path, entry_ec) ||
+                        path.filename().string().find(".tmp.") != std::string::npos) {
+                        continue;
+                    }
+                    Entry entry{path, boost::filesystem::last_write_time(path, entry_ec), 0};
+                    for (boost::filesystem::directory_iterator file(path, entry_ec); !entry_ec && file != end;
+                         file.increment(entry_ec)) {
+                        boost::system::error_code file_ec;
+                        const auto file_size = boost::filesystem::file_size(file->path(), file_ec);
+                        entry.size += file_ec ? 0 : file_size;
+                    }
+                    total_size += entry.size;
+                    entries.push_back(entry);
+                }
+
+                std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+                    return lhs.last_use < rhs.last_use;
+                });
+                for (const auto& entry : entries) {
+                    if (total_size <= size_limit_) {
+                        break;
+                    }
+                    if (entry.path.filename() == keep_key) {
+                        continue;
+                    }
+                    BOOST_LOG_TRIVIAL(info) << "Evicting preprocessing cache entry " << entry.path;
+                    boost::filesystem::remove_all(entry.path, ec);
+                    if (!ec) {
+                        total_size -= entry.size;
+                    }
+                }
+            }
+
+            const boost::filesystem::path directory_;
+            const std::uint64_t size_limit_;
+        };
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_PREPROCESSING_CACHE_HPP
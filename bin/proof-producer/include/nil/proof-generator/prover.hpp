@@ -20,9 +20,16 @@
 #ifndef PROOF_GENERATOR_ASSIGNER_PROOF_HPP
 #define PROOF_GENERATOR_ASSIGNER_PROOF_HPP
 
+#include <cstdint>
 #include <fstream>
+#include <future>
+#include <iomanip>
 #include <random>
 #include <sstream>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 #include <boost/log/trivial.hpp>
 
@@ -31,6 +38,7 @@
 #include <nil/marshalling/status_type.hpp>
 
 #include <nil/crypto3/algebra/fields/arithmetic_params/pallas.hpp>
+#include <nil/crypto3/algebra/fields/arithmetic_params/vesta.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/eval_storage.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/lpc.hpp>
 #include <nil/crypto3/marshalling/zk/types/placeholder/common_data.hpp>
@@ -54,25 +62,63 @@
 #include <nil/blueprint/transpiler/recursive_verifier_generator.hpp>
 
 
+#include <nil/proof-generator/allocator.hpp>
 #include <nil/proof-generator/arithmetization_params.hpp>
+#include <nil/proof-generator/assignment_table_file.hpp>
+#include <nil/proof-generator/circuit_file.hpp>
+#include <nil/proof-generator/compressed_file.hpp>
 #include <nil/proof-generator/file_operations.hpp>
+#include <nil/proof-generator/metrics.hpp>
+#include <nil/proof-generator/parallel.hpp>
+#include <nil/proof-generator/preprocessing_cache.hpp>
+#include <nil/proof-generator/sectioned_file.hpp>
 
 namespace nil {
     namespace proof_generator {
         namespace detail {
-            template<typename MarshallingType>
-            std::optional<MarshallingType> decode_marshalling_from_file(
+            // Marshalled structures are made of many small containers, which live only until the result is built
+            // from them. If an arena is given, they are allocated from it, and the caller frees them at once by
+            // destroying the arena after the marshalled structure.
+            template<typename MarshallingType, typename Iterator>
+            std::optional<MarshallingType> decode_marshalling(
+                Iterator read_iter,
+                std::size_t size,
                 const boost::filesystem::path& path,
-                bool hex = false
+                AllocationArena* arena = nullptr
             ) {
-                const auto v = hex ? read_hex_file_to_vector(path.c_str()) : read_file_to_vector(path.c_str());
-                if (!v.has_value()) {
+                MarshallingType marshalled_data;
+                nil::marshalling::status_type status;
+                {
+                    std::optional<ArenaScope> arena_scope;
+                    if (arena != nullptr) {
+                        arena_scope.emplace(*arena);
+                    }
+                    status = marshalled_data.read(read_iter, size);
+                }
+                if (status != nil::marshalling::status_type::success) {
+                    BOOST_LOG_TRIVIAL(error) << "When reading a Marshalled structure from file " << path << ", decoding step failed";
                     return std::nullopt;
                 }
+                return marshalled_data;
+            }
 
+            // Reads only the first FieldsCount fields of a bundle, the rest of the input is not even parsed.
+            template<typename MarshallingType, std::size_t FieldsCount, typename Iterator>
+            std::optional<MarshallingType> decode_marshalling_prefix(
+                Iterator read_iter,
+                std::size_t size,
+                const boost::filesystem::path& path,
+                AllocationArena* arena = nullptr
+            ) {
                 MarshallingType marshalled_data;
-                auto read_iter = v->begin();
-                auto status = marshalled_data.read(read_iter, v->size());
+                nil::marshalling::status_type status;
+                {
+                    std::optional<ArenaScope> arena_scope;
+                    if (arena != nullptr) {
+                        arena_scope.emplace(*arena);
+                    }
+                    status = marshalled_data.template read_until<FieldsCount>(read_iter, size);
+                }
                 if (status != nil::marshalling::status_type::success) {
                     BOOST_LOG_TRIVIAL(error) << "When reading a Marshalled structure from file " << path << ", decoding step failed";
                     return std::nullopt;
@@ -80,37 +126,193 @@ namespace nil {
                 return marshalled_data;
             }
 
+            // Sections of the bundle written by 'all' stage with --bundle, see Prover::start_bundle.
+            enum class BundleSection : std::uint64_t {
+                NONE = 0,
+                PROOF = 1,
+                PROOF_JSON = 2,
+                COMMON_DATA = 3,
+                PUBLIC_PREPROCESSED_DATA = 4,
+                COMMITMENT_STATE = 5
+            };
+            constexpr std::size_t bundle_sections_count = 5;
+
+            // Fields of the marshalled assignment table, in the order they are stored.
+            enum AssignmentTableField : std::size_t {
+                USABLE_ROWS_AMOUNT = 0,
+                ROWS_AMOUNT = 1,
+                WITNESS_COLUMNS_AMOUNT = 2,
+                PUBLIC_INPUT_COLUMNS_AMOUNT = 3,
+                CONSTANT_COLUMNS_AMOUNT = 4,
+                SELECTOR_COLUMNS_AMOUNT = 5,
+                WITNESS_VALUES = 6,
+                PUBLIC_INPUT_VALUES = 7,
+                CONSTANT_VALUES = 8,
+                SELECTOR_VALUES = 9,
+                ASSIGNMENT_TABLE_FIELDS_COUNT = 10
+            };
+
+            // Calls decode(data, size) with the file content. Compressed files are decompressed into memory first,
+            // unlike plain ones, which are decoded from their mapping. If the file is a bundle, the given section of
+            // it is decoded instead, so any input option may point to the bundle.
+            template<typename Decode>
+            auto decode_file(
+                const boost::filesystem::path& path,
+                bool hex,
+                Decode decode,
+                BundleSection bundle_section = BundleSection::NONE
+            ) -> decltype(decode(std::declval<const std::uint8_t*>(), std::size_t())) {
+                const auto sectioned_file_kind = SectionedFile::kind(path.string());
+                if (sectioned_file_kind == SectionedFileKind::COMPRESSED) {
+                    const auto data = read_compressed_file(path.string());
+                    if (!data.has_value()) {
+                        return std::nullopt;
+                    }
+                    return decode(data->data(), data->size());
+                }
+
+                if (bundle_section != BundleSection::NONE && sectioned_file_kind.has_value()) {
+                    const auto bundle = SectionedFile::open(path.string(), SectionedFileKind::BUNDLE);
+                    if (!bundle.has_value()) {
+                        return std::nullopt;
+                    }
+                    const auto section = bundle->section(static_cast<std::uint64_t>(bundle_section));
+                    if (!section.has_value()) {
+                        BOOST_LOG_TRIVIAL(error) << "Bundle " << path << " has no section "
+                                                 << static_cast<std::uint64_t>(bundle_section);
+                        return std::nullopt;
+                    }
+                    return decode(section->data, section->size);
+                }
+
+                if (hex) {
+                    const auto v = read_hex_file_to_vector(path.c_str());
+                    if (!v.has_value()) {
+                        return std::nullopt;
+                    }
+                    return decode(v->data(), v->size());
+                }
+
+                // Binary files are decoded right from the mapping, without copying them to memory first
+                const auto mapped_file = MappedFile::open(path.c_str());
+                if (!mapped_file.has_value()) {
+                    return std::nullopt;
+                }
+                return decode(mapped_file->data(), mapped_file->size());
+            }
+
+            template<typename MarshallingType>
+            std::optional<MarshallingType> decode_marshalling_from_file(
+                const boost::filesystem::path& path,
+                bool hex = false,
+                BundleSection bundle_section = BundleSection::NONE,
+                AllocationArena* arena = nullptr
+            ) {
+                return decode_file(
+                    path,
+                    hex,
+                    [&path, arena](const std::uint8_t* data, std::size_t size) {
+                        return decode_marshalling<MarshallingType>(data, size, path, arena);
+                    },
+                    bundle_section
+                );
+            }
+
+            template<typename MarshallingType, std::size_t FieldsCount>
+            std::optional<MarshallingType> decode_marshalling_prefix_from_file(
+                const boost::filesystem::path& path,
+                bool hex = false,
+                AllocationArena* arena = nullptr
+            ) {
+                return decode_file(path, hex, [&path, arena](const std::uint8_t* data, std::size_t size) {
+                    return decode_marshalling_prefix<MarshallingType, FieldsCount>(data, size, path, arena);
+                });
+            }
+
             template<typename MarshallingType>
             bool encode_marshalling_to_file(
                 const boost::filesystem::path& path,
                 const MarshallingType& data_for_marshalling,
                 bool hex = false
             ) {
-                std::vector<std::uint8_t> v;
-                v.resize(data_for_marshalling.length(), 0x00);
-                auto write_iter = v.begin();
-                nil::marshalling::status_type status = data_for_marshalling.write(write_iter, v.size());
+                // Data is serialized straight into the file buffer, without an in-memory copy of the whole encoding
+                auto writer = BufferedFileWriter::open(path.c_str(), hex);
+                if (!writer.has_value()) {
+                    return false;
+                }
+
+                auto write_iter = writer->begin();
+                nil::marshalling::status_type status = data_for_marshalling.write(
+                    write_iter,
+                    data_for_marshalling.length()
+                );
+                if (status != nil::marshalling::status_type::success) {
+                    BOOST_LOG_TRIVIAL(error) << "Marshalled structure encoding failed";
+                    return false;
+                }
+
+                return writer->close();
+            }
+
+            template<typename MarshallingType>
+            std::optional<std::vector<std::uint8_t>> encode_marshalling_to_vector(
+                const MarshallingType& data_for_marshalling
+            ) {
+                std::vector<std::uint8_t> encoded(data_for_marshalling.length());
+                auto write_iter = encoded.begin();
+                nil::marshalling::status_type status = data_for_marshalling.write(write_iter, encoded.size());
+                if (status != nil::marshalling::status_type::success) {
+                    BOOST_LOG_TRIVIAL(error) << "Marshalled structure encoding failed";
+                    return std::nullopt;
+                }
+                return encoded;
+            }
+
+            // Written files are read back by decode_marshalling_from_file like the uncompressed ones.
+            template<typename MarshallingType>
+            bool encode_marshalling_to_compressed_file(
+                const boost::filesystem::path& path,
+                const MarshallingType& data_for_marshalling,
+                int level
+            ) {
+                // Data is serialized straight into the blocks being compressed, as in encode_marshalling_to_file
+                auto writer = CompressedFileWriter::open(path.string(), data_for_marshalling.length(), level);
+                if (!writer.has_value()) {
+                    return false;
+                }
+
+                auto write_iter = writer->begin();
+                nil::marshalling::status_type status = data_for_marshalling.write(
+                    write_iter,
+                    data_for_marshalling.length()
+                );
                 if (status != nil::marshalling::status_type::success) {
                     BOOST_LOG_TRIVIAL(error) << "Marshalled structure encoding failed";
                     return false;
                 }
 
-                return hex ? write_vector_to_hex_file(v, path.c_str()) : write_vector_to_file(v, path.c_str());
+                return writer->close();
             }
 
             enum class ProverStage {
                 ALL = 0,
                 PREPROCESS = 1,
                 PROVE = 2,
-                VERIFY = 3
+                VERIFY = 3,
+                SERVE = 4,
+                CONVERT_TABLE = 5,
+                CONVERT_CIRCUIT = 6
             };
 
-            ProverStage prover_stage_from_string(const std::string& stage) {
+            inline ProverStage prover_stage_from_string(const std::string& stage) {
                 static std::unordered_map<std::string, ProverStage> stage_map = {
                     {"all", ProverStage::ALL},
                     {"preprocess", ProverStage::PREPROCESS},
                     {"prove", ProverStage::PROVE},
-                    {"verify", ProverStage::VERIFY}
+                    {"verify", ProverStage::VERIFY},
+                    {"serve", ProverStage::SERVE},
+                    {"convert-table", ProverStage::CONVERT_TABLE},
+                    {"convert-circuit", ProverStage::CONVERT_CIRCUIT}
                 };
                 auto it = stage_map.find(stage);
                 if (it == stage_map.end()) {
@@ -119,6 +321,44 @@ namespace nil {
                 return it->second;
             }
 
+            enum class ProofFormat {
+                BINARY = 0,
+                HEX = 1
+            };
+
+            inline ProofFormat proof_format_from_string(const std::string& format) {
+                static std::unordered_map<std::string, ProofFormat> format_map = {
+                    {"binary", ProofFormat::BINARY},
+                    {"hex", ProofFormat::HEX}
+                };
+                auto it = format_map.find(format);
+                if (it == format_map.end()) {
+                    throw std::invalid_argument("Invalid proof format: " + format);
+                }
+                return it->second;
+            }
+
+            enum class VerificationMode {
+                // Verify before the proof is written
+                SYNC = 0,
+                // Verify concurrently with writing the proof and the rest of the outputs
+                ASYNC = 1,
+                OFF = 2
+            };
+
+            inline VerificationMode verification_mode_from_string(const std::string& mode) {
+                static std::unordered_map<std::string, VerificationMode> mode_map = {
+                    {"sync", VerificationMode::SYNC},
+                    {"async", VerificationMode::ASYNC},
+                    {"off", VerificationMode::OFF}
+                };
+                auto it = mode_map.find(mode);
+                if (it == mode_map.end()) {
+                    throw std::invalid_argument("Invalid verification mode: " + mode);
+                }
+                return it->second;
+            }
+
         } // namespace detail
 
 
@@ -157,81 +397,133 @@ namespace nil {
                 , grind_(grind) {
             }
 
+            // JSON proof is only needed for recursive verification, generating it can be turned off.
+            void set_json_generation(bool enabled) {
+                json_generation_ = enabled;
+            }
+
+            // Public preprocessed data and commitment scheme state are written compressed with this zstd level,
+            // 0 writes them as is. Compressed files are read transparently regardless of the level.
+            void set_compression_level(int level) {
+                compression_level_ = level;
+            }
+
             // The caller must call the preprocessor or load the preprocessed data before calling this function.
+            // With asynchronous verification the result is reported by wait_for_verification(), which must be called
+            // before the circuit or the preprocessed data are replaced. The table description and the FRI params
+            // the proof was generated with are copied for the verifier, so the next job may load its own.
             bool generate_to_file(
                     boost::filesystem::path proof_file_,
                     boost::filesystem::path json_file_,
-                    bool skip_verification) {
+                    detail::VerificationMode verification_mode,
+                    detail::ProofFormat proof_format = detail::ProofFormat::HEX) {
                 if (!nil::proof_generator::can_write_to_file(proof_file_.string())) {
                     BOOST_LOG_TRIVIAL(error) << "Can't write to file " << proof_file_;
                     return false;
                 }
 
+                auto proof = generate_proof(verification_mode);
+                if (!proof) {
+                    return false;
+                }
+
+                if (!json_generation_) {
+                    return save_proof_to_file(*proof, proof_file_, proof_format);
+                }
+                // Both outputs only read the proof, so they are serialized concurrently
+                return run_concurrently({
+                    [&]() {
+                        return save_proof_to_file(*proof, proof_file_, proof_format);
+                    },
+                    [&]() {
+                        // JSON proof is auxiliary, failing to write it does not fail the run
+                        save_json_proof_to_file(*proof, json_file_);
+                        return true;
+                    }
+                });
+            }
+
+            // Starts the bundle file finished by generate_to_bundle, and writes encoded common data, public
+            // preprocessed data and commitment scheme state to it. Must be called before the proof is generated,
+            // while the commitment scheme state is still the one written by 'preprocess' stage.
+            bool start_bundle(const boost::filesystem::path& bundle_file) {
                 BOOST_ASSERT(public_preprocessed_data_);
-                BOOST_ASSERT(private_preprocessed_data_);
-                BOOST_ASSERT(table_description_);
-                BOOST_ASSERT(constraint_system_);
                 BOOST_ASSERT(lpc_scheme_);
 
-                BOOST_LOG_TRIVIAL(info) << "Generating proof...";
-                Proof proof = nil::crypto3::zk::snark::placeholder_prover<BlueprintField, PlaceholderParams>::process(
-                    *public_preprocessed_data_,
-                    *private_preprocessed_data_,
-                    *table_description_,
-                    *constraint_system_,
-                    *lpc_scheme_
-                );
-                BOOST_LOG_TRIVIAL(info) << "Proof generated";
+                if (!nil::proof_generator::can_write_to_file(bundle_file.string())) {
+                    BOOST_LOG_TRIVIAL(error) << "Can't write to file " << bundle_file;
+                    return false;
+                }
+                BOOST_LOG_TRIVIAL(info) << "Writing bundle to " << bundle_file;
+                bundle_writer_ = SectionedFileWriter::open(
+                    bundle_file.string(), SectionedFileKind::BUNDLE, detail::bundle_sections_count);
+                if (!bundle_writer_) {
+                    return false;
+                }
 
-                if (skip_verification) {
-                    BOOST_LOG_TRIVIAL(info) << "Skipping proof verification";
-                } else {
-                    if (!verify(proof)) {
-                        return false;
+                // Each section is encoded straight into the file, so none of them stays in memory while proving
+                auto phase = Metrics::instance().start_phase("bundle_preprocessed_data");
+                return write_bundle_section(detail::BundleSection::COMMON_DATA, marshal_common_data()) &&
+                       write_bundle_section(
+                           detail::BundleSection::PUBLIC_PREPROCESSED_DATA, marshal_public_preprocessed_data()) &&
+                       write_bundle_section(detail::BundleSection::COMMITMENT_STATE, marshal_commitment_state());
+            }
+
+            // Same as generate_to_file, but the binary proof and the JSON proof are added as sections to the bundle
+            // started by start_bundle, which is complete afterwards.
+            bool generate_to_bundle(detail::VerificationMode verification_mode) {
+                BOOST_ASSERT(bundle_writer_);
+
+                auto proof = generate_proof(verification_mode);
+                if (!proof) {
+                    return false;
+                }
+
+                std::string json_proof;
+                bool res = run_concurrently({
+                    [&]() {
+                        auto phase = Metrics::instance().start_phase("marshalling");
+                        return write_bundle_section(detail::BundleSection::PROOF, marshal_proof(*proof));
+                    },
+                    [&]() {
+                        if (json_generation_) {
+                            auto phase = Metrics::instance().start_phase("json_generation");
+                            json_proof = generate_json_proof(*proof);
+                        }
+                        return true;
                     }
+                });
+                if (res && json_generation_) {
+                    bundle_writer_->add_section(
+                        static_cast<std::uint64_t>(detail::BundleSection::PROOF_JSON),
+                        reinterpret_cast<const std::uint8_t*>(json_proof.data()),
+                        json_proof.size());
                 }
 
-                BOOST_LOG_TRIVIAL(info) << "Writing proof to " << proof_file_;
-                auto filled_placeholder_proof =
-                    nil::crypto3::marshalling::types::fill_placeholder_proof<Endianness, Proof>(proof, lpc_scheme_->get_fri_params());
-                bool res = nil::proof_generator::detail::encode_marshalling_to_file(
-                    proof_file_,
-                    filled_placeholder_proof,
-                    true
-                );
+                auto phase = Metrics::instance().start_phase("save_bundle");
+                res = bundle_writer_->close() && res;
+                bundle_writer_.reset();
                 if (res) {
-                    BOOST_LOG_TRIVIAL(info) << "Proof written.";
-                } else {
-                    BOOST_LOG_TRIVIAL(error) << "Failed to write proof to file.";
+                    BOOST_LOG_TRIVIAL(info) << "Bundle written.";
                 }
-
-                BOOST_LOG_TRIVIAL(info) << "Writing json proof to " << json_file_;
-                auto output_file = open_file<std::ofstream>(json_file_.string(), std::ios_base::out);
-                if (!output_file)
-                    return res;
-
-                (*output_file) << nil::blueprint::recursive_verifier_generator<
-                                      PlaceholderParams,
-                                      nil::crypto3::zk::snark::placeholder_proof<BlueprintField, PlaceholderParams>,
-                                      typename nil::crypto3::zk::snark::placeholder_public_preprocessor<
-                                          BlueprintField,
-                                          PlaceholderParams>::preprocessed_data_type::common_data_type>(
-                                      *table_description_
-                )
-                                      .generate_input(*public_inputs_, proof, constraint_system_->public_input_sizes());
-                output_file->close();
-
                 return res;
             }
 
-            bool verify_from_file(boost::filesystem::path proof_file_) {
+            bool verify_from_file(
+                    boost::filesystem::path proof_file_,
+                    detail::ProofFormat proof_format = detail::ProofFormat::HEX) {
                 create_lpc_scheme();
 
                 using ProofMarshalling = nil::crypto3::marshalling::types::
                     placeholder_proof<nil::marshalling::field_type<Endianness>, Proof>;
 
                 BOOST_LOG_TRIVIAL(info) << "Reading proof from file";
-                auto marshalled_proof = detail::decode_marshalling_from_file<ProofMarshalling>(proof_file_, true);
+                auto phase = Metrics::instance().start_phase("read_proof");
+                auto marshalled_proof = detail::decode_marshalling_from_file<ProofMarshalling>(
+                    proof_file_,
+                    proof_format == detail::ProofFormat::HEX,
+                    detail::BundleSection::PROOF
+                );
                 if (!marshalled_proof) {
                     return false;
                 }
@@ -245,13 +537,10 @@ namespace nil {
 
             bool save_preprocessed_common_data_to_file(boost::filesystem::path preprocessed_common_data_file) {
                 BOOST_LOG_TRIVIAL(info) << "Writing preprocessed common data to " << preprocessed_common_data_file << std::endl;
-                auto marshalled_common_data =
-                    nil::crypto3::marshalling::types::fill_placeholder_common_data<Endianness, CommonData>(
-                        public_preprocessed_data_->common_data
-                    );
+                auto phase = Metrics::instance().start_phase("save_preprocessed_common_data");
                 bool res = nil::proof_generator::detail::encode_marshalling_to_file(
                     preprocessed_common_data_file,
-                    marshalled_common_data
+                    marshal_common_data()
                 );
                 if (res) {
                     BOOST_LOG_TRIVIAL(info) << "Preprocessed common data written.";
@@ -261,11 +550,12 @@ namespace nil {
 
             bool read_preprocessed_common_data_from_file(boost::filesystem::path preprocessed_common_data_file) {
                 BOOST_LOG_TRIVIAL(info) << "Read preprocessed common data from " << preprocessed_common_data_file << std::endl;
+                auto phase = Metrics::instance().start_phase("read_preprocessed_common_data");
 
                 using CommonDataMarshalling = nil::crypto3::marshalling::types::placeholder_common_data<TTypeBase, CommonData>;
 
                 auto marshalled_value = detail::decode_marshalling_from_file<CommonDataMarshalling>(
-                    preprocessed_common_data_file);
+                    preprocessed_common_data_file, false, detail::BundleSection::COMMON_DATA);
 
                 if (!marshalled_value) {
                     return false;
@@ -279,20 +569,14 @@ namespace nil {
             // This includes not only the common data, but also merkle trees, polynomials, etc, everything that a 
             // public preprocessor generates.
             bool save_public_preprocessed_data_to_file(boost::filesystem::path preprocessed_data_file) {
-                using namespace nil::crypto3::marshalling::types;
-
                 BOOST_LOG_TRIVIAL(info) << "Writing all preprocessed public data to " << 
                     preprocessed_data_file << std::endl;
-                using PreprocessedPublicDataType = typename PublicPreprocessedData::preprocessed_data_type;
-
-                auto marshalled_preprocessed_public_data =
-                    fill_placeholder_preprocessed_public_data<Endianness, PreprocessedPublicDataType>(
-                        *public_preprocessed_data_
-                    );
-                bool res = nil::proof_generator::detail::encode_marshalling_to_file(
-                    preprocessed_data_file,
-                    marshalled_preprocessed_public_data
-                );
+                auto phase = Metrics::instance().start_phase("save_public_preprocessed_data");
+                bool res = compression_level_ != 0
+                               ? detail::encode_marshalling_to_compressed_file(
+                                     preprocessed_data_file, marshal_public_preprocessed_data(), compression_level_)
+                               : detail::encode_marshalling_to_file(
+                                     preprocessed_data_file, marshal_public_preprocessed_data());
                 if (res) {
                     BOOST_LOG_TRIVIAL(info) << "Preprocessed public data written.";
                 }
@@ -301,6 +585,7 @@ namespace nil {
 
             bool read_public_preprocessed_data_from_file(boost::filesystem::path preprocessed_data_file) {
                 BOOST_LOG_TRIVIAL(info) << "Read preprocessed data from " << preprocessed_data_file << std::endl;
+                auto phase = Metrics::instance().start_phase("read_public_preprocessed_data");
 
                 using namespace nil::crypto3::marshalling::types;
 
@@ -308,8 +593,10 @@ namespace nil {
                 using PublicPreprocessedDataMarshalling =
                     placeholder_preprocessed_public_data<TTypeBase, PreprocessedPublicDataType>;
 
+                // Declared first, so the marshalled structure allocated from it is destroyed before it
+                AllocationArena arena;
                 auto marshalled_value = detail::decode_marshalling_from_file<PublicPreprocessedDataMarshalling>(
-                    preprocessed_data_file);
+                    preprocessed_data_file, false, detail::BundleSection::PUBLIC_PREPROCESSED_DATA, &arena);
                 if (!marshalled_value) {
                     return false;
                 }
@@ -320,17 +607,14 @@ namespace nil {
             }
 
             bool save_commitment_state_to_file(boost::filesystem::path commitment_scheme_state_file) {
-                using namespace nil::crypto3::marshalling::types;
-
                 BOOST_LOG_TRIVIAL(info) << "Writing commitment_state to " << 
                     commitment_scheme_state_file << std::endl;
-
-                auto marshalled_lpc_state = fill_commitment_scheme<Endianness, LpcScheme>(
-                    *lpc_scheme_);
-                bool res = nil::proof_generator::detail::encode_marshalling_to_file(
-                    commitment_scheme_state_file,
-                    marshalled_lpc_state
-                );
+                auto phase = Metrics::instance().start_phase("save_commitment_state");
+                bool res = compression_level_ != 0
+                               ? detail::encode_marshalling_to_compressed_file(
+                                     commitment_scheme_state_file, marshal_commitment_state(), compression_level_)
+                               : detail::encode_marshalling_to_file(
+                                     commitment_scheme_state_file, marshal_commitment_state());
                 if (res) {
                     BOOST_LOG_TRIVIAL(info) << "Commitment scheme written.";
                 }
@@ -339,13 +623,16 @@ namespace nil {
 
             bool read_commitment_scheme_from_file(boost::filesystem::path commitment_scheme_state_file) {
                 BOOST_LOG_TRIVIAL(info) << "Read commitment scheme from " << commitment_scheme_state_file << std::endl;
+                auto phase = Metrics::instance().start_phase("read_commitment_state");
 
                 using namespace nil::crypto3::marshalling::types;
 
                 using CommitmentStateMarshalling = typename commitment_scheme_state<TTypeBase, LpcScheme>::type;
 
+                // Declared first, so the marshalled structure allocated from it is destroyed before it
+                AllocationArena arena;
                 auto marshalled_value = detail::decode_marshalling_from_file<CommitmentStateMarshalling>(
-                    commitment_scheme_state_file);
+                    commitment_scheme_state_file, false, detail::BundleSection::COMMITMENT_STATE, &arena);
                 if (!marshalled_value) {
                     return false;
                 }
@@ -353,15 +640,40 @@ namespace nil {
                 return true;
             }
 
+            // The prover appends its own batches to the commitment scheme, so the state produced by the public
+            // preprocessor has to be kept aside if more than one proof is generated for the same circuit.
+            bool save_commitment_scheme_snapshot() {
+                BOOST_ASSERT(lpc_scheme_);
+                lpc_scheme_snapshot_.emplace(*lpc_scheme_);
+                return true;
+            }
+
+            bool restore_commitment_scheme_snapshot() {
+                BOOST_ASSERT(lpc_scheme_snapshot_);
+                lpc_scheme_.emplace(*lpc_scheme_snapshot_);
+                return true;
+            }
+
+            // Only reads the prover state, so it could run concurrently with saving it.
             bool verify(const Proof& proof) const {
+                return verify(proof, *table_description_, lpc_scheme_->get_fri_params());
+            }
+
+            bool verify(
+                    const Proof& proof,
+                    const TableDescription& table_description,
+                    const FriParams& fri_params) const {
                 BOOST_LOG_TRIVIAL(info) << "Verifying proof...";
+                auto phase = Metrics::instance().start_phase("verify");
+                // Verifier needs only FRI params, not the polynomials committed by the prover
+                LpcScheme lpc_scheme(fri_params);
                 bool verification_result =
                     nil::crypto3::zk::snark::placeholder_verifier<BlueprintField, PlaceholderParams>::process(
                         public_preprocessed_data_.has_value() ? public_preprocessed_data_->common_data : *common_data_,
                         proof,
-                        *table_description_,
+                        table_description,
                         *constraint_system_,
-                        *lpc_scheme_
+                        lpc_scheme
                     );
 
                 if (verification_result) {
@@ -373,13 +685,35 @@ namespace nil {
                 return verification_result;
             }
 
+            // Result of the verification started by generate_to_file, true if there is nothing to wait for.
+            bool wait_for_verification() {
+                if (!verification_.valid()) {
+                    return true;
+                }
+                return verification_.get();
+            }
+
             bool read_circuit(const boost::filesystem::path& circuit_file_) {
                 BOOST_LOG_TRIVIAL(info) << "Read circuit from " << circuit_file_ << std::endl;
+                auto phase = Metrics::instance().start_phase("read_circuit");
+
+                if (SectionedFile::kind(circuit_file_.string()) == SectionedFileKind::CIRCUIT) {
+                    auto constraint_system =
+                        read_sectioned_circuit<Endianness, ConstraintSystem>(circuit_file_.string());
+                    if (!constraint_system) {
+                        return false;
+                    }
+                    constraint_system_.emplace(std::move(*constraint_system));
+                    return true;
+                }
 
                 using ConstraintMarshalling =
                     nil::crypto3::marshalling::types::plonk_constraint_system<TTypeBase, ConstraintSystem>;
 
-                auto marshalled_value = detail::decode_marshalling_from_file<ConstraintMarshalling>(circuit_file_);
+                // Declared first, so the marshalled structure allocated from it is destroyed before it
+                AllocationArena arena;
+                auto marshalled_value = detail::decode_marshalling_from_file<ConstraintMarshalling>(
+                    circuit_file_, false, detail::BundleSection::NONE, &arena);
                 if (!marshalled_value) {
                     return false;
                 }
@@ -391,13 +725,53 @@ namespace nil {
                 return true;
             }
 
+            // Writes the circuit either in the marshalling format or in the sectioned one.
+            bool save_circuit_to_file(const boost::filesystem::path& circuit_file_, bool sectioned = false) {
+                BOOST_LOG_TRIVIAL(info) << "Writing " << (sectioned ? "sectioned " : "") << "circuit to "
+                                        << circuit_file_ << std::endl;
+                auto phase = Metrics::instance().start_phase("save_circuit");
+
+                bool res;
+                if (sectioned) {
+                    res = write_sectioned_circuit<Endianness>(circuit_file_.string(), *constraint_system_);
+                } else {
+                    auto marshalled_circuit =
+                        nil::crypto3::marshalling::types::fill_plonk_constraint_system<Endianness, ConstraintSystem>(
+                            *constraint_system_
+                        );
+                    res = nil::proof_generator::detail::encode_marshalling_to_file(circuit_file_, marshalled_circuit);
+                }
+                if (res) {
+                    BOOST_LOG_TRIVIAL(info) << "Circuit written.";
+                }
+                return res;
+            }
+
+            // Circuit and table could also be built in memory instead of being read, e.g. by benchmarks.
+            void set_circuit(ConstraintSystem constraint_system) {
+                constraint_system_.emplace(std::move(constraint_system));
+            }
+
+            void set_assignment_table(const TableDescription& table_description, AssignmentTable assignment_table) {
+                table_description_.emplace(table_description);
+                assignment_table_.emplace(std::move(assignment_table));
+                public_inputs_.emplace(assignment_table_->public_inputs());
+            }
+
             bool read_assignment_table(const boost::filesystem::path& assignment_table_file_) {
                 BOOST_LOG_TRIVIAL(info) << "Read assignment table from " << assignment_table_file_ << std::endl;
+                auto phase = Metrics::instance().start_phase("read_assignment_table");
+
+                if (SectionedFile::is_sectioned_file(assignment_table_file_.string())) {
+                    return read_columnar_assignment_table(assignment_table_file_, false);
+                }
 
                 using TableValueMarshalling =
                     nil::crypto3::marshalling::types::plonk_assignment_table<TTypeBase, AssignmentTable>;
-                auto marshalled_table =
-                    detail::decode_marshalling_from_file<TableValueMarshalling>(assignment_table_file_);
+                // Declared first, so the marshalled structure allocated from it is destroyed before it
+                AllocationArena arena;
+                auto marshalled_table = detail::decode_marshalling_from_file<TableValueMarshalling>(
+                    assignment_table_file_, false, detail::BundleSection::NONE, &arena);
                 if (!marshalled_table) {
                     return false;
                 }
@@ -407,11 +781,110 @@ namespace nil {
                     );
                 table_description_.emplace(table_description);
                 assignment_table_.emplace(std::move(assignment_table));
+                public_inputs_.emplace(assignment_table_->public_inputs());
+                return true;
+            }
+
+            // Reads only what the prover needs once the public data is preprocessed: table description, witness and
+            // public input columns. Constant and selector columns, stored after them, are not decoded.
+            bool read_private_assignment_table(const boost::filesystem::path& assignment_table_file_) {
+                BOOST_LOG_TRIVIAL(info) << "Read private part of assignment table from " << assignment_table_file_ << std::endl;
+                auto phase = Metrics::instance().start_phase("read_private_assignment_table");
+
+                if (SectionedFile::is_sectioned_file(assignment_table_file_.string())) {
+                    return read_columnar_assignment_table(assignment_table_file_, true);
+                }
+
+                using TableValueMarshalling =
+                    nil::crypto3::marshalling::types::plonk_assignment_table<TTypeBase, AssignmentTable>;
+                static_assert(
+                    std::tuple_size<typename TableValueMarshalling::value_type>::value ==
+                        detail::ASSIGNMENT_TABLE_FIELDS_COUNT,
+                    "Marshalled assignment table layout differs from detail::AssignmentTableField"
+                );
+                // Header integers, then witness and public input columns
+                constexpr std::size_t private_fields_count = detail::PUBLIC_INPUT_VALUES + 1;
+                // Declared first, so the marshalled structure allocated from it is destroyed before it
+                AllocationArena arena;
+                auto marshalled_table = detail::decode_marshalling_prefix_from_file<TableValueMarshalling, private_fields_count>(
+                    assignment_table_file_, false, &arena
+                );
+                if (!marshalled_table) {
+                    return false;
+                }
+
+                const auto& fields = marshalled_table->value();
+                TableDescription table_description(
+                    std::get<detail::WITNESS_COLUMNS_AMOUNT>(fields).value(),
+                    std::get<detail::PUBLIC_INPUT_COLUMNS_AMOUNT>(fields).value(),
+                    std::get<detail::CONSTANT_COLUMNS_AMOUNT>(fields).value(),
+                    std::get<detail::SELECTOR_COLUMNS_AMOUNT>(fields).value()
+                );
+                table_description.usable_rows_amount = std::get<detail::USABLE_ROWS_AMOUNT>(fields).value();
+                table_description.rows_amount = std::get<detail::ROWS_AMOUNT>(fields).value();
+
+                // Values are stored column after column
+                auto witnesses = make_columns(
+                    std::get<detail::WITNESS_VALUES>(fields),
+                    table_description.witness_columns,
+                    table_description.rows_amount
+                );
+                auto public_inputs = make_columns(
+                    std::get<detail::PUBLIC_INPUT_VALUES>(fields),
+                    table_description.public_input_columns,
+                    table_description.rows_amount
+                );
+                if (!witnesses || !public_inputs) {
+                    BOOST_LOG_TRIVIAL(error) << "Assignment table " << assignment_table_file_
+                                             << " is shorter than its description";
+                    return false;
+                }
+                if (!check_preprocessed_table_description(table_description, assignment_table_file_)) {
+                    return false;
+                }
+
+                table_description_.emplace(table_description);
+                assignment_table_.emplace(
+                    typename AssignmentTable::private_table_type(std::move(*witnesses)),
+                    typename AssignmentTable::public_table_type(std::move(*public_inputs), {}, {})
+                );
+                public_inputs_.emplace(assignment_table_->public_inputs());
                 return true;
             }
 
+            // Writes the table read by read_assignment_table, either in the marshalling format or in the columnar one.
+            bool save_assignment_table(const boost::filesystem::path& assignment_table_file, bool columnar) {
+                BOOST_LOG_TRIVIAL(info) << "Writing " << (columnar ? "columnar " : "") << "assignment table to "
+                                        << assignment_table_file << std::endl;
+                auto phase = Metrics::instance().start_phase("save_assignment_table");
+
+                bool res;
+                if (columnar) {
+                    res = write_columnar_assignment_table<Endianness>(
+                        assignment_table_file.string(),
+                        *table_description_,
+                        *assignment_table_
+                    );
+                } else {
+                    auto marshalled_table =
+                        nil::crypto3::marshalling::types::fill_assignment_table<Endianness, AssignmentTable>(
+                            table_description_->usable_rows_amount,
+                            *assignment_table_
+                        );
+                    res = nil::proof_generator::detail::encode_marshalling_to_file(
+                        assignment_table_file,
+                        marshalled_table
+                    );
+                }
+                if (res) {
+                    BOOST_LOG_TRIVIAL(info) << "Assignment table written.";
+                }
+                return res;
+            }
+
             bool save_assignment_description(const boost::filesystem::path& assignment_description_file) {
                 BOOST_LOG_TRIVIAL(info) << "Writing assignment description to " << assignment_description_file << std::endl;
+                auto phase = Metrics::instance().start_phase("save_assignment_description");
 
                 auto marshalled_assignment_description =
                     nil::crypto3::marshalling::types::fill_assignment_table_description<Endianness, BlueprintField>(
@@ -429,6 +902,7 @@ namespace nil {
 
             bool read_assignment_description(const boost::filesystem::path& assignment_description_file_) {
                 BOOST_LOG_TRIVIAL(info) << "Read assignment description from " << assignment_description_file_ << std::endl;
+                auto phase = Metrics::instance().start_phase("read_assignment_description");
 
                 using TableDescriptionMarshalling =
                     nil::crypto3::marshalling::types::plonk_assignment_table_description<TTypeBase>;
@@ -449,15 +923,91 @@ namespace nil {
                 // Lambdas and grinding bits should be passed through preprocessor directives
                 std::size_t table_rows_log = std::ceil(std::log2(table_description_->rows_amount));
 
-                lpc_scheme_.emplace(FriParams(1, table_rows_log, lambda_, expand_factor_));
+                // Zero grinding bits disable proof-of-work
+                lpc_scheme_.emplace(FriParams(1, table_rows_log, lambda_, expand_factor_, grind_ != 0, grind_));
             }
 
-            bool preprocess_public_data() {
-                public_inputs_.emplace(assignment_table_->public_inputs());
+            // Identifies the result of public preprocessing, which depends on the circuit, the table description,
+            // the public columns of the table and the prover parameters. Must be called before preprocessing.
+            std::optional<PreprocessingCache::Key> public_preprocessing_key(
+                const boost::filesystem::path& circuit_file_
+            ) const {
+                boost::system::error_code ec;
+                const auto circuit_size = boost::filesystem::file_size(circuit_file_, ec);
+                const auto circuit_digest = ec ? std::nullopt : digest_file_content(circuit_file_.string());
+                if (!circuit_digest) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to read circuit " << circuit_file_;
+                    return std::nullopt;
+                }
+
+                std::ostringstream fingerprint;
+                fingerprint << parameters_fingerprint() << " circuit_size=" << circuit_size
+                            << " usable_rows=" << table_description_->usable_rows_amount
+                            << " rows=" << table_description_->rows_amount
+                            << " witness_columns=" << table_description_->witness_columns
+                            << " public_input_columns=" << table_description_->public_input_columns
+                            << " constant_columns=" << table_description_->constant_columns
+                            << " selector_columns=" << table_description_->selector_columns;
+
+                ContentDigest digest;
+                digest.update(fingerprint.str());
+                digest.update(*circuit_digest);
+                // Columns are hashed in their marshalled form, which does not depend on the build
+                const std::size_t element_size =
+                    detail::table_element_size<Endianness, typename BlueprintField::value_type>();
+                auto hash_column = [&](const Column& column) {
+                    const auto bytes =
+                        detail::encode_table_column<Endianness>(column, table_description_->rows_amount, element_size);
+                    digest.update(bytes.data(), bytes.size());
+                };
+                for (std::size_t i = 0; i < table_description_->public_input_columns; ++i) {
+                    hash_column(assignment_table_->public_input(i));
+                }
+                for (std::size_t i = 0; i < table_description_->constant_columns; ++i) {
+                    hash_column(assignment_table_->constant(i));
+                }
+                for (std::size_t i = 0; i < table_description_->selector_columns; ++i) {
+                    hash_column(assignment_table_->selector(i));
+                }
+                return PreprocessingCache::Key{digest.hex_digest(), fingerprint.str()};
+            }
+
+            // Identifies a run on the given circuit and assignment table files with the prover parameters. Hashes
+            // the files as they are, so it is available before anything is read.
+            std::optional<PreprocessingCache::Key> input_files_key(
+                const boost::filesystem::path& circuit_file_,
+                const boost::filesystem::path& assignment_table_file_
+            ) const {
+                boost::system::error_code circuit_ec;
+                boost::system::error_code table_ec;
+                const auto circuit_size = boost::filesystem::file_size(circuit_file_, circuit_ec);
+                const auto table_size = boost::filesystem::file_size(assignment_table_file_, table_ec);
+                const auto circuit_digest =
+                    circuit_ec ? std::nullopt : digest_file_content(circuit_file_.string());
+                const auto table_digest =
+                    table_ec ? std::nullopt : digest_file_content(assignment_table_file_.string());
+                if (!circuit_digest || !table_digest) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to read circuit " << circuit_file_ << " or assignment table "
+                                             << assignment_table_file_;
+                    return std::nullopt;
+                }
+
+                std::ostringstream fingerprint;
+                fingerprint << parameters_fingerprint() << " circuit_size=" << circuit_size
+                            << " assignment_table_size=" << table_size;
 
+                ContentDigest digest;
+                digest.update(fingerprint.str());
+                digest.update(*circuit_digest);
+                digest.update(*table_digest);
+                return PreprocessingCache::Key{digest.hex_digest(), fingerprint.str()};
+            }
+
+            bool preprocess_public_data() {
                 create_lpc_scheme();
 
                 BOOST_LOG_TRIVIAL(info) << "Preprocessing public data";
+                auto phase = Metrics::instance().start_phase("preprocess_public_data");
                 public_preprocessed_data_.emplace(
                     nil::crypto3::zk::snark::placeholder_public_preprocessor<BlueprintField, PlaceholderParams>::
                         process(
@@ -468,24 +1018,241 @@ namespace nil {
                             max_quotient_chunks_
                         )
                 );
+                preprocessed_table_description_ = table_description_;
                 return true;
             }
 
             bool preprocess_private_data() {
 
                 BOOST_LOG_TRIVIAL(info) << "Preprocessing private data";
+                auto phase = Metrics::instance().start_phase("preprocess_private_data");
                 private_preprocessed_data_.emplace(
                     nil::crypto3::zk::snark::placeholder_private_preprocessor<BlueprintField, PlaceholderParams>::
                         process(*constraint_system_, assignment_table_->move_private_table(), *table_description_)
                 );
+                return true;
+            }
+
+        private:
+            // Curve, hash and prover parameters, shared by the fingerprints of all keys. The compression level is
+            // included too, since cached and checkpointed artifacts are stored as written at that level.
+            std::string parameters_fingerprint() const {
+                std::ostringstream fingerprint;
+                fingerprint << "curve=" << typeid(CurveType).name() << " hash=" << typeid(HashType).name()
+                            << " lambda=" << lambda_ << " expand_factor=" << expand_factor_
+                            << " max_quotient_chunks=" << max_quotient_chunks_ << " grind=" << grind_
+                            << " compression_level=" << compression_level_;
+                return fingerprint.str();
+            }
 
-                // This is the last stage of preprocessor, and the assignment table is not used after this function call.
+            // Runs the prover and starts or skips verification according to the mode, see generate_to_file.
+            std::optional<Proof> generate_proof(detail::VerificationMode verification_mode) {
+                BOOST_ASSERT(public_preprocessed_data_);
+                BOOST_ASSERT(private_preprocessed_data_);
+                BOOST_ASSERT(table_description_);
+                BOOST_ASSERT(constraint_system_);
+                BOOST_ASSERT(lpc_scheme_);
+
+                // Proving depends on both preprocessing steps, whichever of them finished last, or only on the
+                // private one in 'prove' stage. Each has moved its own part out of the table, so the remainder is
+                // released here rather than by either of them.
                 assignment_table_.reset();
 
+                BOOST_LOG_TRIVIAL(info) << "Generating proof...";
+                auto prove_phase = Metrics::instance().start_phase("prove");
+                Proof proof = nil::crypto3::zk::snark::placeholder_prover<BlueprintField, PlaceholderParams>::process(
+                    *public_preprocessed_data_,
+                    *private_preprocessed_data_,
+                    *table_description_,
+                    *constraint_system_,
+                    *lpc_scheme_
+                );
+                prove_phase.finish();
+                BOOST_LOG_TRIVIAL(info) << "Proof generated";
+
+                // The prover was the last consumer of the private data and of the polynomials it committed to. Only
+                // FRI params are kept for the verifier, batch jobs restore the whole scheme from the snapshot.
+                private_preprocessed_data_.reset();
+                const FriParams fri_params = lpc_scheme_->get_fri_params();
+                lpc_scheme_.emplace(fri_params);
+
+                switch (verification_mode) {
+                    case detail::VerificationMode::SYNC:
+                        if (!verify(proof)) {
+                            return std::nullopt;
+                        }
+                        break;
+                    case detail::VerificationMode::ASYNC:
+                        BOOST_LOG_TRIVIAL(info) << "Verifying proof in background";
+                        // Batch jobs replace the table description and the commitment scheme while it runs
+                        verification_ = std::async(
+                            std::launch::async,
+                            [this, proof, table_description = *table_description_, fri_params]() {
+                                return verify(proof, table_description, fri_params);
+                            });
+                        break;
+                    case detail::VerificationMode::OFF:
+                        BOOST_LOG_TRIVIAL(info) << "Skipping proof verification";
+                        break;
+                }
+                return proof;
+            }
+
+            bool save_proof_to_file(
+                    const Proof& proof,
+                    const boost::filesystem::path& proof_file_,
+                    detail::ProofFormat proof_format) {
+                BOOST_LOG_TRIVIAL(info) << "Writing proof to " << proof_file_;
+                auto phase = Metrics::instance().start_phase("marshalling");
+                bool res = nil::proof_generator::detail::encode_marshalling_to_file(
+                    proof_file_,
+                    marshal_proof(proof),
+                    proof_format == detail::ProofFormat::HEX
+                );
+                if (res) {
+                    BOOST_LOG_TRIVIAL(info) << "Proof written.";
+                } else {
+                    BOOST_LOG_TRIVIAL(error) << "Failed to write proof to file.";
+                }
+                return res;
+            }
+
+            bool save_json_proof_to_file(const Proof& proof, const boost::filesystem::path& json_file_) {
+                BOOST_LOG_TRIVIAL(info) << "Writing json proof to " << json_file_;
+                auto phase = Metrics::instance().start_phase("json_generation");
+                const std::string json_proof = generate_json_proof(proof);
+                // The generator returns the whole document, so it is written with a single call, bypassing iostreams
+                auto writer = BufferedFileWriter::open(json_file_.string());
+                if (!writer.has_value()) {
+                    return false;
+                }
+                writer->write(reinterpret_cast<const std::uint8_t*>(json_proof.data()), json_proof.size());
+                return writer->close();
+            }
+
+            // Input of the recursive verifier, the format is defined by the transpiler.
+            std::string generate_json_proof(const Proof& proof) const {
+                return nil::blueprint::recursive_verifier_generator<
+                           PlaceholderParams,
+                           nil::crypto3::zk::snark::placeholder_proof<BlueprintField, PlaceholderParams>,
+                           typename nil::crypto3::zk::snark::placeholder_public_preprocessor<
+                               BlueprintField,
+                               PlaceholderParams>::preprocessed_data_type::common_data_type>(*table_description_)
+                    .generate_input(*public_inputs_, proof, constraint_system_->public_input_sizes());
+            }
+
+            auto marshal_proof(const Proof& proof) const {
+                return nil::crypto3::marshalling::types::fill_placeholder_proof<Endianness, Proof>(
+                    proof, lpc_scheme_->get_fri_params());
+            }
+
+            auto marshal_common_data() const {
+                return nil::crypto3::marshalling::types::fill_placeholder_common_data<Endianness, CommonData>(
+                    public_preprocessed_data_->common_data);
+            }
+
+            auto marshal_public_preprocessed_data() const {
+                using PreprocessedPublicDataType = typename PublicPreprocessedData::preprocessed_data_type;
+                return nil::crypto3::marshalling::types::
+                    fill_placeholder_preprocessed_public_data<Endianness, PreprocessedPublicDataType>(
+                        *public_preprocessed_data_);
+            }
+
+            auto marshal_commitment_state() {
+                return nil::crypto3::marshalling::types::fill_commitment_scheme<Endianness, LpcScheme>(*lpc_scheme_);
+            }
+
+            // Encodes the data straight into a new section of the bundle.
+            template<typename MarshallingType>
+            bool write_bundle_section(detail::BundleSection section, const MarshallingType& data_for_marshalling) {
+                auto write_iter = bundle_writer_->begin_section(static_cast<std::uint64_t>(section)).begin();
+                nil::marshalling::status_type status = data_for_marshalling.write(
+                    write_iter,
+                    data_for_marshalling.length()
+                );
+                if (status != nil::marshalling::status_type::success) {
+                    BOOST_LOG_TRIVIAL(error) << "Marshalled structure encoding failed";
+                    return false;
+                }
                 return true;
             }
 
-        private:
+            bool read_columnar_assignment_table(const boost::filesystem::path& assignment_table_file_, bool private_only) {
+                auto table = nil::proof_generator::read_columnar_assignment_table<Endianness, AssignmentTable>(
+                    assignment_table_file_.string(),
+                    private_only
+                );
+                if (!table) {
+                    return false;
+                }
+                if (private_only && !check_preprocessed_table_description(table->first, assignment_table_file_)) {
+                    return false;
+                }
+                table_description_.emplace(table->first);
+                assignment_table_.emplace(std::move(table->second));
+                public_inputs_.emplace(assignment_table_->public_inputs());
+                return true;
+            }
+
+            // A private table is proved against public data preprocessed for another table, so its description
+            // must match that one. If the public data was loaded from files, the description is fixed by the table
+            // read before, or else by this one.
+            bool check_preprocessed_table_description(
+                const TableDescription& table_description,
+                const boost::filesystem::path& assignment_table_file_
+            ) {
+                if (!preprocessed_table_description_) {
+                    preprocessed_table_description_.emplace(
+                        table_description_ ? *table_description_ : table_description
+                    );
+                }
+                const TableDescription& expected = *preprocessed_table_description_;
+                if (table_description.rows_amount != expected.rows_amount ||
+                    table_description.usable_rows_amount != expected.usable_rows_amount ||
+                    table_description.witness_columns != expected.witness_columns ||
+                    table_description.public_input_columns != expected.public_input_columns ||
+                    table_description.constant_columns != expected.constant_columns ||
+                    table_description.selector_columns != expected.selector_columns) {
+                    BOOST_LOG_TRIVIAL(error)
+                        << "Assignment table " << assignment_table_file_
+                        << " has rows=" << table_description.rows_amount
+                        << " usable_rows=" << table_description.usable_rows_amount
+                        << " witness_columns=" << table_description.witness_columns
+                        << " public_input_columns=" << table_description.public_input_columns
+                        << " constant_columns=" << table_description.constant_columns
+                        << " selector_columns=" << table_description.selector_columns
+                        << ", the public data was preprocessed for rows=" << expected.rows_amount
+                        << " usable_rows=" << expected.usable_rows_amount
+                        << " witness_columns=" << expected.witness_columns
+                        << " public_input_columns=" << expected.public_input_columns
+                        << " constant_columns=" << expected.constant_columns
+                        << " selector_columns=" << expected.selector_columns;
+                    return false;
+                }
+                return true;
+            }
+
+            // Splits column-major marshalled values into columns_amount columns of rows_amount values.
+            template<typename MarshalledValues>
+            static std::optional<std::vector<Column>> make_columns(
+                const MarshalledValues& marshalled_values,
+                std::size_t columns_amount,
+                std::size_t rows_amount
+            ) {
+                const auto& values = marshalled_values.value();
+                if (values.size() < columns_amount * rows_amount) {
+                    return std::nullopt;
+                }
+                std::vector<Column> columns(columns_amount);
+                for (std::size_t i = 0; i < columns_amount; ++i) {
+                    columns[i].reserve(rows_amount);
+                    for (std::size_t j = 0; j < rows_amount; ++j) {
+                        columns[i].push_back(values[i * rows_amount + j].value());
+                    }
+                }
+                return columns;
+            }
+
             const std::size_t expand_factor_;
             const std::size_t max_quotient_chunks_;
             const std::size_t lambda_;
@@ -500,9 +1267,16 @@ namespace nil {
             std::optional<PrivatePreprocessedData> private_preprocessed_data_;
             std::optional<typename AssignmentTable::public_input_container_type> public_inputs_;
             std::optional<TableDescription> table_description_;
+            // Table the public data and the commitment scheme state were built for
+            std::optional<TableDescription> preprocessed_table_description_;
             std::optional<ConstraintSystem> constraint_system_;
             std::optional<AssignmentTable> assignment_table_;
             std::optional<LpcScheme> lpc_scheme_;
+            std::optional<LpcScheme> lpc_scheme_snapshot_;
+            std::future<bool> verification_;
+            std::optional<SectionedFileWriter> bundle_writer_;
+            bool json_generation_ = true;
+            int compression_level_ = 0;
         };
 
     } // namespace proof_generator
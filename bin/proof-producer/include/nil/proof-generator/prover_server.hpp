@@ -0,0 +1,313 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef PROOF_GENERATOR_PROVER_SERVER_HPP
+#define PROOF_GENERATOR_PROVER_SERVER_HPP
+
+#include <csignal>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <nil/proof-generator/arg_parser.hpp>
+#include <nil/proof-generator/file_operations.hpp>
+#include <nil/proof-generator/prover.hpp>
+
+namespace nil {
+    namespace proof_generator {
+        namespace detail {
+            // One request of the 'serve' stage. Requests are single lines of whitespace separated `key=value`
+            // pairs, e.g.
+            //     circuit=circuit.crct preprocessed-data=preprocessed.dat commitment-state-file=commitment.dat
+            //         assignment-table=assignment.tbl proof=proof.bin json=proof.json
+            // Paths which are not set in the request are taken from the command line options of the server. A
+            // `shutdown` line stops the server.
+            struct ServerJob {
+                boost::filesystem::path circuit_file_path;
+                boost::filesystem::path preprocessed_public_data_path;
+                boost::filesystem::path commitment_scheme_state_path;
+                boost::filesystem::path assignment_table_file_path;
+                boost::filesystem::path proof_file_path;
+                boost::filesystem::path json_file_path;
+            };
+
+            inline std::optional<ServerJob> parse_server_job(const std::string& line, const ProverOptions& defaults) {
+                ServerJob job{
+                    defaults.circuit_file_path,
+                    defaults.preprocessed_public_data_path,
+                    defaults.commitment_scheme_state_path,
+                    defaults.assignment_table_file_path,
+                    defaults.proof_file_path,
+                    defaults.json_file_path
+                };
+                const std::unordered_map<std::string, boost::filesystem::path*> fields = {
+                    {"circuit", &job.circuit_file_path},
+                    {"preprocessed-data", &job.preprocessed_public_data_path},
+                    {"commitment-state-file", &job.commitment_scheme_state_path},
+                    {"assignment-table", &job.assignment_table_file_path},
+                    {"proof", &job.proof_file_path},
+                    {"json", &job.json_file_path}
+                };
+
+                std::istringstream tokens(line);
+                std::string token;
+                while (tokens >> token) {
+                    const auto separator = token.find('=');
+                    if (separator == std::string::npos) {
+                        BOOST_LOG_TRIVIAL(error) << "Malformed request token: " << token;
+                        return std::nullopt;
+                    }
+                    auto it = fields.find(token.substr(0, separator));
+                    if (it == fields.end()) {
+                        BOOST_LOG_TRIVIAL(error) << "Unknown request field: " << token.substr(0, separator);
+                        return std::nullopt;
+                    }
+                    *it->second = token.substr(separator + 1);
+                }
+
+                if (job.circuit_file_path.empty() || job.assignment_table_file_path.empty()) {
+                    BOOST_LOG_TRIVIAL(error) << "Request must contain both circuit and assignment table";
+                    return std::nullopt;
+                }
+                return job;
+            }
+        } // namespace detail
+
+        // Long-running prover which keeps circuits together with their preprocessed data loaded between jobs.
+        // Loaded circuits are identified by the SHA-256 digests of the circuit, preprocessed data and commitment
+        // scheme state files, so renamed or copied inputs don't trigger repeated loading.
+        //
+        // Connections to the socket are served one at a time, each until the client closes it. The server stops
+        // on a `shutdown` request, or on SIGINT or SIGTERM once the current connection is closed, and removes
+        // its socket file.
+        template<typename CurveType, typename HashType>
+        class ProverServer {
+        public:
+            using ProverType = Prover<CurveType, HashType>;
+
+            explicit ProverServer(const ProverOptions& options)
+                : options_(options)
+                , proof_format_(detail::proof_format_from_string(options.proof_format))
+                , verification_mode_(
+                      options.verification_mode.empty()
+                          ? detail::VerificationMode::OFF
+                          : detail::verification_mode_from_string(options.verification_mode)
+                  ) {
+            }
+
+            int run() {
+                if (options_.socket_path.empty()) {
+                    BOOST_LOG_TRIVIAL(info) << "Serving requests from stdin";
+                    serve(std::cin, std::cout);
+                    return 0;
+                }
+
+                using stream_protocol = boost::asio::local::stream_protocol;
+
+                if (boost::filesystem::status(options_.socket_path).type() == boost::filesystem::socket_file) {
+                    // Stale socket left by a previous server instance
+                    boost::filesystem::remove(options_.socket_path);
+                }
+
+                boost::asio::io_context io_context;
+                stream_protocol::acceptor acceptor(io_context, stream_protocol::endpoint(options_.socket_path.string()));
+                // Signals are delivered while the server waits for a connection, closing the acceptor
+                boost::asio::signal_set signals(io_context, SIGINT, SIGTERM);
+                signals.async_wait([&acceptor](const boost::system::error_code& ec, int signal_number) {
+                    if (!ec) {
+                        BOOST_LOG_TRIVIAL(info) << "Stopping on signal " << signal_number;
+                        acceptor.close();
+                    }
+                });
+                BOOST_LOG_TRIVIAL(info) << "Serving requests on " << options_.socket_path;
+
+                int result = 0;
+                bool shutdown = false;
+                while (!shutdown) {
+                    stream_protocol::iostream stream;
+                    bool accepted = false;
+                    boost::system::error_code accept_ec;
+                    acceptor.async_accept(stream.socket(), [&](const boost::system::error_code& ec) {
+                        accepted = true;
+                        accept_ec = ec;
+                    });
+                    while (!accepted && io_context.run_one() != 0) {
+                    }
+                    if (!accepted || accept_ec) {
+                        if (accept_ec != boost::asio::error::operation_aborted) {
+                            BOOST_LOG_TRIVIAL(error) << "Unable to accept a connection: " << accept_ec.message();
+                            result = 1;
+                        }
+                        break;
+                    }
+                    shutdown = serve(stream, stream);
+                }
+
+                boost::system::error_code ec;
+                acceptor.close(ec);
+                boost::filesystem::remove(options_.socket_path, ec);
+                BOOST_LOG_TRIVIAL(info) << "Server stopped";
+                return result;
+            }
+
+            // Answers each request line with either `ok <proof file>` or `error <reason>`. Returns true if the
+            // server is requested to stop.
+            bool serve(std::istream& requests, std::ostream& responses) {
+                std::string line;
+                while (std::getline(requests, line)) {
+                    std::istringstream words(line);
+                    std::string word;
+                    if (!(words >> word)) {
+                        continue;
+                    }
+                    if (word == "shutdown" && !(words >> word)) {
+                        responses << "ok shutdown" << std::endl;
+                        return true;
+                    }
+                    auto job = detail::parse_server_job(line, options_);
+                    if (!job) {
+                        responses << "error malformed request" << std::endl;
+                        continue;
+                    }
+
+                    bool job_result;
+                    try {
+                        job_result = process_job(*job);
+                    } catch (const std::exception& e) {
+                        BOOST_LOG_TRIVIAL(error) << e.what();
+                        job_result = false;
+                    }
+                    if (job_result) {
+                        responses << "ok " << job->proof_file_path.string() << std::endl;
+                    } else {
+                        responses << "error proof generation failed for "
+                                  << job->assignment_table_file_path.string() << std::endl;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            bool process_job(const detail::ServerJob& job) {
+                ProverType* prover = get_prover(job);
+                if (!prover) {
+                    return false;
+                }
+                const bool proved =
+                    prover->read_private_assignment_table(job.assignment_table_file_path) &&
+                    prover->restore_commitment_scheme_snapshot() &&
+                    prover->preprocess_private_data() &&
+                    prover->generate_to_file(
+                        job.proof_file_path,
+                        job.json_file_path,
+                        verification_mode_,
+                        proof_format_
+                    );
+                // Verification may have started even if writing the proof failed, it is finished before the next job
+                return prover->wait_for_verification() && proved;
+            }
+
+            ProverType* get_prover(const detail::ServerJob& job) {
+                std::string key;
+                for (const auto& path : {
+                         job.circuit_file_path,
+                         job.preprocessed_public_data_path,
+                         job.commitment_scheme_state_path
+                     }) {
+                    auto file_digest = get_file_digest(path);
+                    if (!file_digest) {
+                        return nullptr;
+                    }
+                    key += *file_digest;
+                }
+
+                for (auto it = provers_.begin(); it != provers_.end(); ++it) {
+                    if (it->first == key) {
+                        // Move to the front, so the least recently used circuit is the last one
+                        provers_.splice(provers_.begin(), provers_, it);
+                        return provers_.front().second.get();
+                    }
+                }
+
+                BOOST_LOG_TRIVIAL(info) << "Loading circuit " << job.circuit_file_path;
+                auto prover = std::make_unique<ProverType>(
+                    options_.lambda,
+                    options_.expand_factor,
+                    options_.max_quotient_chunks,
+                    options_.grind
+                );
+                prover->set_json_generation(!options_.skip_json);
+                bool loaded = prover->read_circuit(job.circuit_file_path) &&
+                              prover->read_public_preprocessed_data_from_file(job.preprocessed_public_data_path) &&
+                              prover->read_commitment_scheme_from_file(job.commitment_scheme_state_path) &&
+                              prover->save_commitment_scheme_snapshot();
+                if (!loaded) {
+                    return nullptr;
+                }
+
+                while (!provers_.empty() && provers_.size() >= options_.server_cache_size) {
+                    BOOST_LOG_TRIVIAL(info) << "Evicting least recently used circuit";
+                    provers_.pop_back();
+                }
+                provers_.emplace_front(key, std::move(prover));
+                return provers_.front().second.get();
+            }
+
+            // Content digests are remembered by file identity, so unchanged files are hashed only once.
+            std::optional<std::string> get_file_digest(const boost::filesystem::path& path) {
+                boost::system::error_code ec;
+                const auto size = boost::filesystem::file_size(path, ec);
+                const auto mtime = ec ? 0 : boost::filesystem::last_write_time(path, ec);
+                if (ec) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to access file " << path << ": " << ec.message();
+                    return std::nullopt;
+                }
+                const std::string identity = boost::filesystem::absolute(path).string() + ":" +
+                                             std::to_string(size) + ":" + std::to_string(mtime);
+
+                auto it = file_digests_.find(identity);
+                if (it != file_digests_.end()) {
+                    return it->second;
+                }
+                auto file_digest = digest_file_content(path.string());
+                if (file_digest) {
+                    file_digests_.emplace(identity, *file_digest);
+                }
+                return file_digest;
+            }
+
+            const ProverOptions options_;
+            const detail::ProofFormat proof_format_;
+            const detail::VerificationMode verification_mode_;
+            std::list<std::pair<std::string, std::unique_ptr<ProverType>>> provers_;
+            std::unordered_map<std::string, std::string> file_digests_;
+        };
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_PROVER_SERVER_HPP
@@ -0,0 +1,28 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_RUN_PROVER_HPP
+#define PROOF_GENERATOR_RUN_PROVER_HPP
+
+#include <nil/proof-generator/arg_parser.hpp>
+
+// Runs the requested stage for the curve and hash pair. Explicitly instantiated for every pair of CurveTypes and
+// HashTypes in its own translation unit of the core library, so callers only need this declaration.
+template<typename CurveType, typename HashType>
+int run_prover(const nil::proof_generator::ProverOptions& prover_options);
+
+#endif // PROOF_GENERATOR_RUN_PROVER_HPP
@@ -0,0 +1,461 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef PROOF_GENERATOR_SCHEDULER_HPP
+#define PROOF_GENERATOR_SCHEDULER_HPP
+
+#include <cerrno>
+#include <deque>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <nil/proof-generator/arg_parser.hpp>
+#include <nil/proof-generator/batch.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        using CpuPool = std::vector<int>;
+
+        namespace detail {
+            // Parses Linux cpulist format, e.g. "0-3,8,10-11".
+            inline CpuPool parse_cpu_list(const std::string& cpu_list) {
+                CpuPool cpus;
+                std::vector<std::string> ranges;
+                boost::algorithm::split(ranges, boost::algorithm::trim_copy(cpu_list), boost::is_any_of(","));
+                for (const auto& range : ranges) {
+                    if (range.empty()) {
+                        continue;
+                    }
+                    const auto dash = range.find('-');
+                    const int first = std::stoi(range.substr(0, dash));
+                    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    if (last < first) {
+                        throw std::invalid_argument("Invalid CPU range: " + range);
+                    }
+                    for (int cpu = first; cpu <= last; ++cpu) {
+                        cpus.push_back(cpu);
+                    }
+                }
+                return cpus;
+            }
+
+            // Ignores SIGPIPE while alive and then restores the previous disposition, so writes to a worker which has
+            // exited fail with EPIPE instead of killing the scheduler, without changing the handling for the rest
+            // of the process.
+            class ScopedSigpipeIgnore {
+            public:
+                ScopedSigpipeIgnore() {
+                    struct sigaction ignore = {};
+                    ignore.sa_handler = SIG_IGN;
+                    sigemptyset(&ignore.sa_mask);
+                    installed_ = sigaction(SIGPIPE, &ignore, &previous_) == 0;
+                }
+
+                ~ScopedSigpipeIgnore() {
+                    if (installed_) {
+                        sigaction(SIGPIPE, &previous_, nullptr);
+                    }
+                }
+
+                ScopedSigpipeIgnore(const ScopedSigpipeIgnore&) = delete;
+                ScopedSigpipeIgnore& operator=(const ScopedSigpipeIgnore&) = delete;
+
+            private:
+                struct sigaction previous_;
+                bool installed_;
+            };
+        } // namespace detail
+
+        // Pools are separated by ';', each pool is a cpulist, e.g. "0-15;16-31".
+        inline std::vector<CpuPool> parse_cpu_pools(const std::string& pools_spec) {
+            std::vector<std::string> pool_specs;
+            boost::algorithm::split(pool_specs, pools_spec, boost::is_any_of(";"));
+            std::vector<CpuPool> pools;
+            for (const auto& pool_spec : pool_specs) {
+                CpuPool pool = detail::parse_cpu_list(pool_spec);
+                if (!pool.empty()) {
+                    pools.push_back(std::move(pool));
+                }
+            }
+            return pools;
+        }
+
+        // Splits CPUs available to the process into pools_amount contiguous pools of (almost) equal size.
+        inline std::vector<CpuPool> split_available_cpus(std::size_t pools_amount) {
+            cpu_set_t available;
+            CPU_ZERO(&available);
+            if (sched_getaffinity(0, sizeof(available), &available) != 0) {
+                throw std::runtime_error("Unable to get CPU affinity of the process");
+            }
+            CpuPool cpus;
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &available)) {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            pools_amount = std::min(pools_amount, cpus.size());
+            std::vector<CpuPool> pools(pools_amount);
+            for (std::size_t i = 0; i < cpus.size(); ++i) {
+                pools[i * pools_amount / cpus.size()].push_back(cpus[i]);
+            }
+            return pools;
+        }
+
+        // One pool per NUMA node, so that each job works with memory local to its cores.
+        inline std::vector<CpuPool> numa_node_cpu_pools() {
+            std::vector<CpuPool> pools;
+            for (std::size_t node = 0;; ++node) {
+                std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                if (!cpu_list_file) {
+                    break;
+                }
+                std::string cpu_list;
+                std::getline(cpu_list_file, cpu_list);
+                CpuPool pool = detail::parse_cpu_list(cpu_list);
+                if (!pool.empty()) {
+                    pools.push_back(std::move(pool));
+                }
+            }
+            if (pools.empty()) {
+                BOOST_LOG_TRIVIAL(warning) << "NUMA topology is not available, using a single pool";
+                return split_available_cpus(1);
+            }
+            return pools;
+        }
+
+        // Runs independent proof jobs concurrently. Each CPU pool gets a worker process, which is this executable
+        // in the 'serve' stage pinned to the pool, so every job runs on a core budget of its pool's size and the
+        // worker keeps the circuit loaded between jobs. Jobs are handed out one at a time to whichever worker is
+        // idle, so pools which drain early pick up the remaining work instead of waiting for a static share. A job
+        // which can't be handed to a worker because it has exited goes back to the queue for the remaining workers,
+        // and so does a job whose worker exits while running it, until the job was started max_job_attempts times.
+        class ProofScheduler {
+        public:
+            ProofScheduler(std::vector<std::string> worker_args, std::vector<CpuPool> pools)
+                : worker_args_(std::move(worker_args))
+                , pools_(std::move(pools)) {
+            }
+
+            // Bounds the workers a job that crashes them, e.g. by running out of memory, can take down
+            static constexpr std::size_t max_job_attempts = 2;
+
+            bool run(const std::vector<ProofJob>& jobs) {
+                // A worker exiting in the middle of a request must requeue or fail the job, not kill the scheduler
+                detail::ScopedSigpipeIgnore sigpipe_ignore;
+
+                bool result = true;
+                std::deque<std::size_t> pending;
+                std::vector<std::size_t> attempts(jobs.size(), 0);
+                for (std::size_t i = 0; i < jobs.size(); ++i) {
+                    if (is_valid_job(jobs[i])) {
+                        pending.push_back(i);
+                    } else {
+                        result = false;
+                    }
+                }
+
+                for (const auto& pool : pools_) {
+                    auto worker = start_worker(pool);
+                    if (worker) {
+                        workers_.push_back(*worker);
+                    }
+                }
+                if (workers_.empty()) {
+                    BOOST_LOG_TRIVIAL(error) << "No worker process could be started";
+                    return false;
+                }
+                BOOST_LOG_TRIVIAL(info) << "Scheduling " << jobs.size() << " jobs on " << workers_.size()
+                                        << " worker pools";
+
+                std::size_t running = 0;
+                while (true) {
+                    for (auto& worker : workers_) {
+                        // A failed send marks the worker dead and leaves the job pending for the next idle one
+                        if (worker.alive && !worker.job && !pending.empty() &&
+                            send_job(worker, jobs[pending.front()])) {
+                            worker.job = pending.front();
+                            pending.pop_front();
+                            ++attempts[*worker.job];
+                            ++running;
+                        }
+                    }
+                    if (running == 0) {
+                        break;
+                    }
+
+                    std::vector<pollfd> poll_fds;
+                    std::vector<Worker*> polled_workers;
+                    for (auto& worker : workers_) {
+                        if (worker.job) {
+                            poll_fds.push_back({worker.from_worker, POLLIN, 0});
+                            polled_workers.push_back(&worker);
+                        }
+                    }
+                    if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        BOOST_LOG_TRIVIAL(error) << "Waiting for worker processes failed";
+                        result = false;
+                        break;
+                    }
+
+                    for (std::size_t i = 0; i < poll_fds.size(); ++i) {
+                        if (poll_fds[i].revents == 0) {
+                            continue;
+                        }
+                        Worker& worker = *polled_workers[i];
+                        const ProofJob& job = jobs[*worker.job];
+                        auto response = read_response(worker);
+                        if (!response && worker.alive) {
+                            // Partial line, wait for the rest of it
+                            continue;
+                        }
+                        if (!response && attempts[*worker.job] < max_job_attempts) {
+                            BOOST_LOG_TRIVIAL(warning) << "Worker exited while running job for "
+                                                       << job.assignment_table_file_path << ", requeuing it";
+                            pending.push_front(*worker.job);
+                        } else if (!response || response->rfind("ok", 0) != 0) {
+                            BOOST_LOG_TRIVIAL(error) << "Job for " << job.assignment_table_file_path << " failed";
+                            result = false;
+                        } else {
+                            BOOST_LOG_TRIVIAL(info) << "Proof for " << job.assignment_table_file_path
+                                                    << " written to " << job.proof_file_path;
+                        }
+                        worker.job.reset();
+                        --running;
+                    }
+                }
+
+                if (!pending.empty()) {
+                    BOOST_LOG_TRIVIAL(error) << pending.size() << " jobs were not run, all workers have exited";
+                    result = false;
+                }
+                stop_workers();
+                return result;
+            }
+
+        private:
+            struct Worker {
+                pid_t pid;
+                int to_worker;
+                int from_worker;
+                bool alive;
+                std::string read_buffer;
+                std::optional<std::size_t> job;
+            };
+
+            std::optional<Worker> start_worker(const CpuPool& pool) {
+                int requests[2];
+                int responses[2];
+                if (pipe2(requests, O_CLOEXEC) != 0) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to create pipe for worker process";
+                    return std::nullopt;
+                }
+                if (pipe2(responses, O_CLOEXEC) != 0) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to create pipe for worker process";
+                    ::close(requests[0]);
+                    ::close(requests[1]);
+                    return std::nullopt;
+                }
+
+                cpu_set_t cpu_set;
+                CPU_ZERO(&cpu_set);
+                for (int cpu : pool) {
+                    CPU_SET(cpu, &cpu_set);
+                }
+
+                // Everything the child needs is prepared before fork, the child only makes syscalls.
+                const std::string executable = boost::filesystem::read_symlink("/proc/self/exe").string();
+                std::vector<char*> argv;
+                argv.push_back(const_cast<char*>(executable.c_str()));
+                for (const auto& arg : worker_args_) {
+                    argv.push_back(const_cast<char*>(arg.c_str()));
+                }
+                argv.push_back(nullptr);
+
+                const pid_t pid = fork();
+                if (pid < 0) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to start worker process";
+                    for (int fd : {requests[0], requests[1], responses[0], responses[1]}) {
+                        ::close(fd);
+                    }
+                    return std::nullopt;
+                }
+                if (pid == 0) {
+                    // Ignored signals stay ignored across exec, the worker gets the default SIGPIPE handling back
+                    struct sigaction default_action = {};
+                    default_action.sa_handler = SIG_DFL;
+                    sigemptyset(&default_action.sa_mask);
+                    sigaction(SIGPIPE, &default_action, nullptr);
+                    sched_setaffinity(0, sizeof(cpu_set), &cpu_set);
+                    dup2(requests[0], STDIN_FILENO);
+                    dup2(responses[1], STDOUT_FILENO);
+                    execv(argv[0], argv.data());
+                    _exit(127);
+                }
+
+                ::close(requests[0]);
+                ::close(responses[1]);
+                BOOST_LOG_TRIVIAL(info) << "Started worker " << pid << " on " << pool.size() << " CPUs";
+                return Worker{pid, requests[1], responses[0], true, {}, std::nullopt};
+            }
+
+            // Requests are whitespace separated, so such paths can't be passed to a worker.
+            static bool is_valid_job(const ProofJob& job) {
+                for (const auto& path : {job.assignment_table_file_path, job.proof_file_path, job.json_file_path}) {
+                    if (path.string().find_first_of(" \t\n") != std::string::npos) {
+                        BOOST_LOG_TRIVIAL(error) << "Paths with whitespaces are not supported by the scheduler: "
+                                                 << path;
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // False if the worker has exited, it is marked dead then.
+            bool send_job(Worker& worker, const ProofJob& job) {
+                const std::string request = "assignment-table=" + job.assignment_table_file_path.string() +
+                                            " proof=" + job.proof_file_path.string() +
+                                            " json=" + job.json_file_path.string() + "\n";
+                std::size_t written = 0;
+                while (written < request.size()) {
+                    const ssize_t res = ::write(worker.to_worker, request.data() + written, request.size() - written);
+                    if (res < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (res < 0) {
+                        BOOST_LOG_TRIVIAL(error) << "Worker " << worker.pid << " is not accepting jobs";
+                        worker.alive = false;
+                        return false;
+                    }
+                    written += static_cast<std::size_t>(res);
+                }
+                return true;
+            }
+
+            // Returns a complete response line, or nothing if the line is not complete yet or the worker has exited.
+            std::optional<std::string> read_response(Worker& worker) {
+                char buffer[4096];
+                const ssize_t res = ::read(worker.from_worker, buffer, sizeof(buffer));
+                if (res <= 0) {
+                    if (res < 0 && errno == EINTR) {
+                        return std::nullopt;
+                    }
+                    BOOST_LOG_TRIVIAL(error) << "Worker " << worker.pid << " has exited unexpectedly";
+                    worker.alive = false;
+                    return std::nullopt;
+                }
+                worker.read_buffer.append(buffer, static_cast<std::size_t>(res));
+                const auto line_end = worker.read_buffer.find('\n');
+                if (line_end == std::string::npos) {
+                    return std::nullopt;
+                }
+                std::string line = worker.read_buffer.substr(0, line_end);
+                worker.read_buffer.erase(0, line_end + 1);
+                return line;
+            }
+
+            void stop_workers() {
+                for (auto& worker : workers_) {
+                    // Worker exits on the end of its input
+                    ::close(worker.to_worker);
+                    ::close(worker.from_worker);
+                    int status;
+                    while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+                    }
+                }
+                workers_.clear();
+            }
+
+            const std::vector<std::string> worker_args_;
+            const std::vector<CpuPool> pools_;
+            std::vector<Worker> workers_;
+        };
+
+        // Command line of a worker, which serves jobs for the preprocessed circuit given in the options.
+        inline std::vector<std::string> make_worker_args(const ProverOptions& options) {
+            auto to_string = [](const auto& value) {
+                std::ostringstream stream;
+                stream << value;
+                return stream.str();
+            };
+            std::vector<std::string> args = {
+                "--stage", "serve",
+                "--circuit", options.circuit_file_path.string(),
+                "--preprocessed-data", options.preprocessed_public_data_path.string(),
+                "--commitment-state-file", options.commitment_scheme_state_path.string(),
+                "--proof-format", options.proof_format,
+                "--log-level", to_string(options.log_level),
+                "--elliptic-curve-type", to_string(options.elliptic_curve_type),
+                "--hash-type", to_string(options.hash_type),
+                "--lambda-param", std::to_string(options.lambda),
+                "--grind-param", std::to_string(options.grind),
+                "--expand-factor", std::to_string(options.expand_factor),
+                "--max-quotient-chunks", std::to_string(options.max_quotient_chunks),
+                "--server-cache-size", "1"
+            };
+            if (options.memory_limit_mb != 0) {
+                // The limit applies to each worker process
+                args.insert(args.end(), {
+                    "--memory-limit", std::to_string(options.memory_limit_mb),
+                    "--scratch-dir", options.scratch_dir_path.string()
+                });
+            }
+            if (!options.verification_mode.empty()) {
+                args.insert(args.end(), {"--verify", options.verification_mode});
+            }
+            if (options.skip_json) {
+                args.push_back("--skip-json");
+            }
+            return args;
+        }
+
+        // Pools requested by the options, empty if jobs should run one after another in this process.
+        inline std::vector<CpuPool> cpu_pools_from_options(const ProverOptions& options) {
+            if (!options.cpu_pools.empty()) {
+                return parse_cpu_pools(options.cpu_pools);
+            }
+            if (options.numa_pools) {
+                return numa_node_cpu_pools();
+            }
+            if (options.parallel_jobs > 1) {
+                return split_available_cpus(options.parallel_jobs);
+            }
+            return {};
+        }
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_SCHEDULER_HPP
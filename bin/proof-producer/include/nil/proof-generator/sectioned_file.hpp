@@ -0,0 +1,323 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_SECTIONED_FILE_HPP
+#define PROOF_GENERATOR_SECTIONED_FILE_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/log/trivial.hpp>
+
+#include <nil/proof-generator/file_operations.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Container of independently addressable binary sections:
+        //     magic "NILSECT1" | u32 kind | u32 reserved | u64 sections count
+        //     index of (u64 id, u64 offset, u64 size) per section
+        //     section bodies, each starting at a section_alignment-aligned offset
+        // All integers are little-endian. Sections can be read without touching the rest of the file, so
+        // independent parts of an artifact are decoded in parallel straight from the mapping.
+        namespace detail {
+            constexpr char sectioned_file_magic[8] = {'N', 'I', 'L', 'S', 'E', 'C', 'T', '1'};
+            constexpr std::size_t sectioned_file_header_size = 24;
+            constexpr std::size_t sectioned_file_index_entry_size = 24;
+            constexpr std::size_t section_alignment = 64;
+
+            inline void store_le(std::uint8_t* out, std::uint64_t value, std::size_t bytes) {
+                for (std::size_t i = 0; i < bytes; ++i) {
+                    out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+                }
+            }
+
+            inline std::uint64_t load_le(const std::uint8_t* in, std::size_t bytes) {
+                std::uint64_t value = 0;
+                for (std::size_t i = 0; i < bytes; ++i) {
+                    value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+                }
+                return value;
+            }
+
+            inline std::size_t align_section_offset(std::size_t offset) {
+                return (offset + section_alignment - 1) / section_alignment * section_alignment;
+            }
+        } // namespace detail
+
+        // Kinds of sectioned files, so that one artifact is never taken for another.
+        enum class SectionedFileKind : std::uint32_t {
+            ASSIGNMENT_TABLE = 1,
+            BUNDLE = 2,
+            COMPRESSED = 3,
+            CIRCUIT = 4
+        };
+
+        struct Section {
+            std::uint64_t id;
+            std::vector<std::uint8_t> data;
+        };
+
+        // Writes sections one after another as they are produced, so no section has to be kept in memory until the
+        // whole file is ready. Space for the index of up to max_sections entries is reserved after the header and
+        // filled in by close, readers find no sections in a file which was not closed successfully.
+        class SectionedFileWriter {
+        public:
+            static std::optional<SectionedFileWriter> open(
+                const std::string& path,
+                SectionedFileKind kind,
+                std::size_t max_sections
+            ) {
+                auto writer = BufferedFileWriter::open(path);
+                if (!writer.has_value()) {
+                    return std::nullopt;
+                }
+                std::vector<std::uint8_t> header(
+                    detail::sectioned_file_header_size + max_sections * detail::sectioned_file_index_entry_size
+                );
+                std::memcpy(header.data(), detail::sectioned_file_magic, sizeof(detail::sectioned_file_magic));
+                detail::store_le(header.data() + 8, static_cast<std::uint32_t>(kind), 4);
+                writer->write(header.data(), header.size());
+                return SectionedFileWriter(path, std::move(*writer), std::move(header), max_sections);
+            }
+
+            // Starts a new section, its body is written through the returned writer until the next call or close.
+            // Sections beyond max_sections are dropped from the index, and close reports the file as failed.
+            BufferedFileWriter& begin_section(std::uint64_t id) {
+                end_section();
+                if (entries_.size() == max_sections_) {
+                    BOOST_LOG_TRIVIAL(error) << "Section " << id << " exceeds the " << max_sections_
+                                             << " sections reserved in file " << path_;
+                    failed_ = true;
+                    return writer_;
+                }
+                const std::uint8_t padding[detail::section_alignment] = {};
+                writer_.write(padding, detail::align_section_offset(writer_.size()) - writer_.size());
+                entries_.push_back({id, writer_.size(), 0});
+                in_section_ = true;
+                return writer_;
+            }
+
+            void add_section(std::uint64_t id, const std::uint8_t* data, std::size_t size) {
+                begin_section(id).write(data, size);
+            }
+
+            // Flushes the sections and writes the index in place of the reserved space.
+            bool close() {
+                end_section();
+                if (!writer_.close() || failed_) {
+                    return false;
+                }
+                detail::store_le(header_.data() + 16, entries_.size(), 8);
+                for (std::size_t i = 0; i < entries_.size(); ++i) {
+                    std::uint8_t* entry = header_.data() + detail::sectioned_file_header_size +
+                                          i * detail::sectioned_file_index_entry_size;
+                    detail::store_le(entry, entries_[i].id, 8);
+                    detail::store_le(entry + 8, entries_[i].offset, 8);
+                    detail::store_le(entry + 16, entries_[i].size, 8);
+                }
+
+                const int fd = ::open(path_.c_str(), O_WRONLY);
+                if (fd < 0) {
+                    BOOST_LOG_TRIVIAL(error) << "Unable to open file: " << path_;
+                    return false;
+                }
+                bool res = true;
+                std::size_t written = 0;
+                while (res && written < header_.size()) {
+                    const ssize_t chunk = ::pwrite(fd, header_.data() + written, header_.size() - written, written);
+                    if (chunk < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    res = chunk > 0;
+                    written += res ? static_cast<std::size_t>(chunk) : 0;
+                }
+                res = ::close(fd) == 0 && res;
+                if (!res) {
+                    BOOST_LOG_TRIVIAL(error) << "Error occurred during writing index of file " << path_;
+                }
+                return res;
+            }
+
+        private:
+            struct Entry {
+                std::uint64_t id;
+                std::uint64_t offset;
+                std::uint64_t size;
+            };
+
+            SectionedFileWriter(
+                const std::string& path,
+                BufferedFileWriter writer,
+                std::vector<std::uint8_t> header,
+                std::size_t max_sections
+            )
+                : path_(path)
+                , writer_(std::move(writer))
+                , header_(std::move(header))
+                , max_sections_(max_sections)
+                , in_section_(false)
+                , failed_(false) {
+            }
+
+            void end_section() {
+                if (in_section_) {
+                    entries_.back().size = writer_.size() - entries_.back().offset;
+                    in_section_ = false;
+                }
+            }
+
+            std::string path_;
+            BufferedFileWriter writer_;
+            std::vector<std::uint8_t> header_;
+            std::size_t max_sections_;
+            std::vector<Entry> entries_;
+            bool in_section_;
+            bool failed_;
+        };
+
+        inline bool write_sectioned_file(
+            const std::string& path,
+            SectionedFileKind kind,
+            const std::vector<Section>& sections
+        ) {
+            auto writer = SectionedFileWriter::open(path, kind, sections.size());
+            if (!writer.has_value()) {
+                return false;
+            }
+            for (const auto& section : sections) {
+                writer->add_section(section.id, section.data.data(), section.data.size());
+            }
+            return writer->close();
+        }
+
+        // Sectioned file mapped into memory, sections point into the mapping.
+        class SectionedFile {
+        public:
+            struct SectionView {
+                const std::uint8_t* data;
+                std::size_t size;
+            };
+
+            // Checks the magic only, so callers can choose between the sectioned and the legacy readers.
+            static bool is_sectioned_file(const std::string& path) {
+                auto file = open_file<std::ifstream>(path, std::ios_base::in | std::ios_base::binary);
+                if (!file.has_value()) {
+                    return false;
+                }
+                char magic[sizeof(detail::sectioned_file_magic)];
+                file->read(magic, sizeof(magic));
+                return file->gcount() == sizeof(magic) &&
+                       std::memcmp(magic, detail::sectioned_file_magic, sizeof(magic)) == 0;
+            }
+
+            // Kind of the sectioned file, nullopt if the file is not a sectioned one.
+            static std::optional<SectionedFileKind> kind(const std::string& path) {
+                auto file = open_file<std::ifstream>(path, std::ios_base::in | std::ios_base::binary);
+                if (!file.has_value()) {
+                    return std::nullopt;
+                }
+                std::uint8_t header[12];
+                file->read(reinterpret_cast<char*>(header), sizeof(header));
+                if (file->gcount() != sizeof(header) ||
+                    std::memcmp(header, detail::sectioned_file_magic, sizeof(detail::sectioned_file_magic)) != 0) {
+                    return std::nullopt;
+                }
+                return static_cast<SectionedFileKind>(detail::load_le(header + 8, 4));
+            }
+
+            static std::optional<SectionedFile> open(const std::string& path, SectionedFileKind kind) {
+                auto mapped_file = MappedFile::open(path);
+                if (!mapped_file.has_value()) {
+                    return std::nullopt;
+                }
+
+                const std::uint8_t* data = mapped_file->data();
+                const std::size_t size = mapped_file->size();
+                if (size < detail::sectioned_file_header_size ||
+                    std::memcmp(data, detail::sectioned_file_magic, sizeof(detail::sectioned_file_magic)) != 0) {
+                    BOOST_LOG_TRIVIAL(error) << "File " << path << " is not a sectioned file";
+                    return std::nullopt;
+                }
+                if (detail::load_le(data + 8, 4) != static_cast<std::uint32_t>(kind)) {
+                    BOOST_LOG_TRIVIAL(error) << "Sectioned file " << path << " contains another kind of data";
+                    return std::nullopt;
+                }
+
+                const std::uint64_t sections_count = detail::load_le(data + 16, 8);
+                if (sections_count > (size - detail::sectioned_file_header_size) / detail::sectioned_file_index_entry_size) {
+                    BOOST_LOG_TRIVIAL(error) << "Sectioned file " << path << " has truncated index";
+                    return std::nullopt;
+                }
+
+                std::vector<Entry> index;
+                index.reserve(sections_count);
+                for (std::uint64_t i = 0; i < sections_count; ++i) {
+                    const std::uint8_t* entry = data + detail::sectioned_file_header_size +
+                                                i * detail::sectioned_file_index_entry_size;
+                    Entry section{detail::load_le(entry, 8), detail::load_le(entry + 8, 8), detail::load_le(entry + 16, 8)};
+                    if (section.offset > size || section.size > size - section.offset) {
+                        BOOST_LOG_TRIVIAL(error) << "Section " << section.id << " of " << path << " is out of file bounds";
+                        return std::nullopt;
+                    }
+                    index.push_back(section);
+                }
+                return SectionedFile(std::move(*mapped_file), std::move(index));
+            }
+
+            std::size_t sections_count() const {
+                return index_.size();
+            }
+
+            std::optional<SectionView> section(std::uint64_t id) const {
+                for (const auto& entry : index_) {
+                    if (entry.id == id) {
+                        return SectionView{mapped_file_.data() + entry.offset, entry.size};
+                    }
+                }
+                return std::nullopt;
+            }
+
+        private:
+            struct Entry {
+                std::uint64_t id;
+                std::uint64_t offset;
+                std::uint64_t size;
+            };
+
+            SectionedFile(MappedFile mapped_file, std::vector<Entry> index)
+                : mapped_file_(std::move(mapped_file))
+                , index_(std::move(index)) {
+            }
+
+            MappedFile mapped_file_;
+            std::vector<Entry> index_;
+        };
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_SECTIONED_FILE_HPP
@@ -0,0 +1,237 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#ifndef PROOF_GENERATOR_VERIFIER_HPP
+#define PROOF_GENERATOR_VERIFIER_HPP
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <nil/proof-generator/arg_parser.hpp>
+#include <nil/proof-generator/circuit_file.hpp>
+#include <nil/proof-generator/metrics.hpp>
+#include <nil/proof-generator/parallel.hpp>
+#include <nil/proof-generator/prover.hpp>
+#include <nil/proof-generator/sectioned_file.hpp>
+
+namespace nil {
+    namespace proof_generator {
+
+        // Verifies proofs of one circuit. Only the circuit, the common data and the table description are loaded,
+        // once for all proofs, and proofs are verified in parallel, each with its own commitment scheme.
+        template<typename CurveType, typename HashType>
+        class Verifier {
+        public:
+            using ProverType = Prover<CurveType, HashType>;
+            using BlueprintField = typename ProverType::BlueprintField;
+            using LpcScheme = typename ProverType::LpcScheme;
+            using PlaceholderParams = typename ProverType::PlaceholderParams;
+            using Proof = typename ProverType::Proof;
+            using CommonData = typename ProverType::CommonData;
+            using ConstraintSystem = typename ProverType::ConstraintSystem;
+            using TableDescription = typename ProverType::TableDescription;
+            using Endianness = typename ProverType::Endianness;
+            using FriParams = typename ProverType::FriParams;
+            using TTypeBase = typename ProverType::TTypeBase;
+
+            Verifier(std::size_t lambda, std::size_t expand_factor, std::size_t grind)
+                : lambda_(lambda)
+                , expand_factor_(expand_factor)
+                , grind_(grind) {
+            }
+
+            bool read_circuit(const boost::filesystem::path& circuit_file) {
+                BOOST_LOG_TRIVIAL(info) << "Read circuit from " << circuit_file;
+                auto phase = Metrics::instance().start_phase("read_circuit");
+
+                if (SectionedFile::kind(circuit_file.string()) == SectionedFileKind::CIRCUIT) {
+                    auto constraint_system =
+                        read_sectioned_circuit<Endianness, ConstraintSystem>(circuit_file.string());
+                    if (!constraint_system) {
+                        return false;
+                    }
+                    constraint_system_.emplace(std::move(*constraint_system));
+                    return true;
+                }
+
+                using ConstraintMarshalling =
+                    nil::crypto3::marshalling::types::plonk_constraint_system<TTypeBase, ConstraintSystem>;
+                // Declared first, so the marshalled structure allocated from it is destroyed before it
+                AllocationArena arena;
+                auto marshalled_value = detail::decode_marshalling_from_file<ConstraintMarshalling>(
+                    circuit_file, false, detail::BundleSection::NONE, &arena);
+                if (!marshalled_value) {
+                    return false;
+                }
+                constraint_system_.emplace(
+                    nil::crypto3::marshalling::types::make_plonk_constraint_system<Endianness, ConstraintSystem>(
+                        *marshalled_value
+                    )
+                );
+                return true;
+            }
+
+            bool read_preprocessed_common_data_from_file(const boost::filesystem::path& common_data_file) {
+                BOOST_LOG_TRIVIAL(info) << "Read preprocessed common data from " << common_data_file;
+                auto phase = Metrics::instance().start_phase("read_preprocessed_common_data");
+
+                using CommonDataMarshalling =
+                    nil::crypto3::marshalling::types::placeholder_common_data<TTypeBase, CommonData>;
+                auto marshalled_value = detail::decode_marshalling_from_file<CommonDataMarshalling>(
+                    common_data_file, false, detail::BundleSection::COMMON_DATA);
+                if (!marshalled_value) {
+                    return false;
+                }
+                common_data_.emplace(
+                    nil::crypto3::marshalling::types::make_placeholder_common_data<Endianness, CommonData>(
+                        *marshalled_value
+                    )
+                );
+                return true;
+            }
+
+            bool read_assignment_description(const boost::filesystem::path& assignment_description_file) {
+                BOOST_LOG_TRIVIAL(info) << "Read assignment description from " << assignment_description_file;
+                auto phase = Metrics::instance().start_phase("read_assignment_description");
+
+                using TableDescriptionMarshalling =
+                    nil::crypto3::marshalling::types::plonk_assignment_table_description<TTypeBase>;
+                auto marshalled_description =
+                    detail::decode_marshalling_from_file<TableDescriptionMarshalling>(assignment_description_file);
+                if (!marshalled_description) {
+                    return false;
+                }
+                table_description_.emplace(
+                    nil::crypto3::marshalling::types::make_assignment_table_description<Endianness, BlueprintField>(
+                        *marshalled_description
+                    )
+                );
+
+                // Lambdas and grinding bits should be passed through preprocessor directives
+                std::size_t table_rows_log = std::ceil(std::log2(table_description_->rows_amount));
+                fri_params_.emplace(1, table_rows_log, lambda_, expand_factor_, grind_ != 0, grind_);
+                return true;
+            }
+
+            // Reads and verifies every proof, returns true if all of them are valid. Failed proofs are reported
+            // one by one, the rest of the batch is still verified.
+            bool verify_from_files(
+                const std::vector<boost::filesystem::path>& proof_files,
+                detail::ProofFormat proof_format = detail::ProofFormat::HEX
+            ) const {
+                BOOST_ASSERT(constraint_system_);
+                BOOST_ASSERT(common_data_);
+                BOOST_ASSERT(table_description_);
+
+                std::atomic<std::size_t> failed(0);
+                parallel_for(proof_files.size(), [&](std::size_t i) {
+                    if (!verify_from_file(proof_files[i], proof_format)) {
+                        BOOST_LOG_TRIVIAL(error) << "Proof " << proof_files[i] << " is not valid";
+                        ++failed;
+                    }
+                });
+                if (failed != 0) {
+                    BOOST_LOG_TRIVIAL(error) << failed << " of " << proof_files.size() << " proofs failed verification";
+                    return false;
+                }
+                BOOST_LOG_TRIVIAL(info) << "All " << proof_files.size() << " proofs are verified";
+                return true;
+            }
+
+        private:
+            bool verify_from_file(const boost::filesystem::path& proof_file, detail::ProofFormat proof_format) const {
+                using ProofMarshalling = nil::crypto3::marshalling::types::placeholder_proof<TTypeBase, Proof>;
+
+                BOOST_LOG_TRIVIAL(info) << "Verifying proof " << proof_file;
+                auto read_phase = Metrics::instance().start_phase("read_proof");
+                // Proofs are decoded on several threads at once, each into its own arena instead of the shared heap
+                AllocationArena arena;
+                auto marshalled_proof = detail::decode_marshalling_from_file<ProofMarshalling>(
+                    proof_file,
+                    proof_format == detail::ProofFormat::HEX,
+                    detail::BundleSection::PROOF,
+                    &arena
+                );
+                if (!marshalled_proof) {
+                    return false;
+                }
+                const Proof proof =
+                    nil::crypto3::marshalling::types::make_placeholder_proof<Endianness, Proof>(*marshalled_proof);
+                read_phase.finish();
+
+                auto verify_phase = Metrics::instance().start_phase("verify");
+                // The verifier appends to the scheme, so concurrent verifications must not share one
+                LpcScheme lpc_scheme(*fri_params_);
+                return nil::crypto3::zk::snark::placeholder_verifier<BlueprintField, PlaceholderParams>::process(
+                    *common_data_,
+                    proof,
+                    *table_description_,
+                    *constraint_system_,
+                    lpc_scheme
+                );
+            }
+
+            const std::size_t lambda_;
+            const std::size_t expand_factor_;
+            const std::size_t grind_;
+
+            std::optional<ConstraintSystem> constraint_system_;
+            std::optional<CommonData> common_data_;
+            std::optional<TableDescription> table_description_;
+            std::optional<FriParams> fri_params_;
+        };
+
+        // Runs 'verify' stage for the proof passed with --proof, or for all proofs passed with --proofs.
+        template<typename CurveType, typename HashType>
+        int run_verifier(const ProverOptions& options) {
+            try {
+                Verifier<CurveType, HashType> verifier(options.lambda, options.expand_factor, options.grind);
+                const std::vector<boost::filesystem::path> proof_files =
+                    options.proof_file_paths.empty() ? std::vector<boost::filesystem::path>{options.proof_file_path}
+                                                     : options.proof_file_paths;
+                // Inputs are independent, so they are decoded concurrently
+                bool result =
+                    run_concurrently({
+                        [&]() {
+                            return verifier.read_circuit(options.circuit_file_path);
+                        },
+                        [&]() {
+                            return verifier.read_preprocessed_common_data_from_file(
+                                options.preprocessed_common_data_path);
+                        },
+                        [&]() {
+                            return verifier.read_assignment_description(options.assignment_description_file_path);
+                        }
+                    }) &&
+                    verifier.verify_from_files(proof_files, detail::proof_format_from_string(options.proof_format));
+                return result ? 0 : 1;
+            } catch (const std::exception& e) {
+                BOOST_LOG_TRIVIAL(error) << e.what();
+                return 1;
+            }
+        }
+
+    } // namespace proof_generator
+} // namespace nil
+
+#endif // PROOF_GENERATOR_VERIFIER_HPP
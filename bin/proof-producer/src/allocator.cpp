@@ -0,0 +1,599 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+#include "nil/proof-generator/allocator.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <linux/magic.h>
+#include <sys/mman.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#include <boost/log/trivial.hpp>
+
+// Heap blocks are plain malloc blocks without any header, so until accounting is enabled operator new and delete
+// cost as much as malloc and free. Blocks of other origins are recognized by their address: arena chunks are
+// carved from one reserved address range, and scratch mappings are page-aligned and registered in a table, which
+// is looked up only for page-aligned pointers while mappings exist.
+
+namespace nil {
+    namespace proof_generator {
+        namespace {
+            // Counters of the threads, each on its own cache line, summed on read. A slot written by one thread only
+            // is updated without read-modify-write instructions; threads beyond the slots amount share the last slot
+            // and update it atomically. A thread returns its slot when it exits, the counts stay in the slot and
+            // the next thread taking it adds to them, so short-lived threads don't use the slots up.
+            struct alignas(64) CounterSlot {
+                std::atomic<std::int64_t> heap_bytes{0};
+                std::atomic<std::uint64_t> allocations{0};
+            };
+            constexpr std::size_t counter_slots_amount = 128;
+            constexpr std::size_t shared_counter_slot = counter_slots_amount - 1;
+
+            struct MappedBlock {
+                void* base;
+                std::size_t length;
+                std::size_t size;
+            };
+            // Mappings are at least min_spilled_allocation_size each, so this covers several GiB of spilled data.
+            // Allocations stay on the heap once the table is full.
+            constexpr std::size_t mapped_blocks_capacity = 4096;
+
+            constexpr std::size_t arena_chunk_size = 4 << 20;
+            // Reserved address space of arena chunks is 64 GiB, arenas fall back to the heap once it is used up
+            constexpr std::size_t arena_chunks_capacity = 16 << 10;
+
+            // Plain globals with constant initialization, so they are usable before any static constructor runs
+            std::atomic<bool> accounting_enabled(false);
+            std::atomic<bool> limit_enabled(false);
+            std::uint64_t memory_limit = 0;
+            char scratch_directory[PATH_MAX] = {};
+            std::atomic<bool> scratch_failure_reported(false);
+
+            CounterSlot counter_slots[counter_slots_amount];
+            std::mutex counter_slots_mutex;
+            std::size_t counter_slots_used = 0;
+            std::size_t free_counter_slots[shared_counter_slot];
+            std::size_t free_counter_slots_amount = 0;
+            // Slots are returned by a pthread key destructor rather than by a thread_local object, whose
+            // registration could allocate from inside operator new
+            pthread_once_t counter_slot_key_once = PTHREAD_ONCE_INIT;
+            pthread_key_t counter_slot_key;
+            bool counter_slot_key_created = false;
+            thread_local CounterSlot* thread_counter_slot = nullptr;
+            // Updated on large allocations and on reads of the statistics only
+            alignas(64) std::atomic<std::uint64_t> peak_heap_bytes(0);
+            std::atomic<std::uint64_t> spilled_bytes(0);
+            std::atomic<std::uint64_t> peak_spilled_bytes(0);
+            std::atomic<std::uint64_t> arena_allocations(0);
+
+            std::mutex mapped_blocks_mutex;
+            MappedBlock mapped_blocks[mapped_blocks_capacity];
+            std::atomic<std::size_t> mapped_blocks_amount(0);
+
+            std::mutex arena_chunks_mutex;
+            std::atomic<std::uintptr_t> arena_range(0);
+            bool arena_range_failed = false;
+            std::size_t arena_chunks_used = 0;
+            // Ring of released chunks, oldest first
+            std::uint32_t free_arena_chunks[arena_chunks_capacity];
+            std::size_t first_free_arena_chunk = 0;
+            std::size_t free_arena_chunks_amount = 0;
+            std::atomic<bool> live_arena_chunks[arena_chunks_capacity] = {};
+
+            thread_local AllocationArena* current_arena = nullptr;
+
+            void update_peak(std::atomic<std::uint64_t>& peak, std::uint64_t value) {
+                std::uint64_t current = peak.load(std::memory_order_relaxed);
+                while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+                }
+            }
+
+            void create_counter_slot_key();
+
+            CounterSlot& thread_counters() {
+                if (thread_counter_slot == nullptr) {
+                    pthread_once(&counter_slot_key_once, create_counter_slot_key);
+                    std::size_t slot = shared_counter_slot;
+                    {
+                        // The lock also orders the counts left by the previous owner of the slot before new ones
+                        std::lock_guard<std::mutex> lock(counter_slots_mutex);
+                        if (free_counter_slots_amount != 0) {
+                            slot = free_counter_slots[--free_counter_slots_amount];
+                        } else if (counter_slots_used < shared_counter_slot) {
+                            slot = counter_slots_used++;
+                        }
+                    }
+                    thread_counter_slot = &counter_slots[slot];
+                    if (slot != shared_counter_slot && counter_slot_key_created) {
+                        pthread_setspecific(counter_slot_key, thread_counter_slot);
+                    }
+                }
+                return *thread_counter_slot;
+            }
+
+            void release_counter_slot(void* slot) {
+                std::lock_guard<std::mutex> lock(counter_slots_mutex);
+                free_counter_slots[free_counter_slots_amount++] =
+                    static_cast<std::size_t>(static_cast<CounterSlot*>(slot) - counter_slots);
+                // Allocations of the destructors which run after this one go to the shared slot
+                thread_counter_slot = &counter_slots[shared_counter_slot];
+            }
+
+            void create_counter_slot_key() {
+                counter_slot_key_created = pthread_key_create(&counter_slot_key, release_counter_slot) == 0;
+            }
+
+            template<typename Value>
+            void add_to_counter(CounterSlot& slot, std::atomic<Value>& counter, Value value) {
+                if (&slot == &counter_slots[shared_counter_slot]) {
+                    counter.fetch_add(value, std::memory_order_relaxed);
+                } else {
+                    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+                }
+            }
+
+            std::uint64_t current_heap_bytes() {
+                std::int64_t total = 0;
+                for (const auto& slot : counter_slots) {
+                    total += slot.heap_bytes.load(std::memory_order_relaxed);
+                }
+                // Blocks allocated before accounting was enabled are subtracted when they are freed
+                return total > 0 ? static_cast<std::uint64_t>(total) : 0;
+            }
+
+            std::size_t page_size() {
+                static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+                return size;
+            }
+
+            std::size_t mapping_length(std::size_t size) {
+                return (size + page_size() - 1) / page_size() * page_size();
+            }
+
+            int open_scratch_file() {
+#ifdef O_TMPFILE
+                int fd = ::open(scratch_directory, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+                if (fd >= 0) {
+                    return fd;
+                }
+#endif
+                // Filesystems without O_TMPFILE support
+                char path[PATH_MAX];
+                if (std::snprintf(path, sizeof(path), "%s/proof-producer-scratch-XXXXXX", scratch_directory) >=
+                    static_cast<int>(sizeof(path))) {
+                    return -1;
+                }
+                int unlinked_fd = mkostemp(path, O_CLOEXEC);
+                if (unlinked_fd >= 0) {
+                    unlink(path);
+                }
+                return unlinked_fd;
+            }
+
+            // Returns nullptr if the scratch file can't be created, the caller falls back to the heap then.
+            void* allocate_mapped(std::size_t size, std::size_t alignment) {
+                // Mappings are only page-aligned
+                if (alignment > page_size() || mapped_blocks_amount.load(std::memory_order_relaxed) == mapped_blocks_capacity) {
+                    return nullptr;
+                }
+                const std::size_t length = mapping_length(size);
+
+                int fd = open_scratch_file();
+                if (fd < 0) {
+                    return nullptr;
+                }
+                void* base = MAP_FAILED;
+                if (ftruncate(fd, static_cast<off_t>(length)) == 0) {
+                    base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                }
+                // The mapping keeps the unlinked file alive until munmap
+                ::close(fd);
+                if (base == MAP_FAILED) {
+                    return nullptr;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mapped_blocks_mutex);
+                    const std::size_t amount = mapped_blocks_amount.load(std::memory_order_relaxed);
+                    if (amount == mapped_blocks_capacity) {
+                        munmap(base, length);
+                        return nullptr;
+                    }
+                    mapped_blocks[amount] = {base, length, size};
+                    mapped_blocks_amount.store(amount + 1, std::memory_order_relaxed);
+                }
+                update_peak(peak_spilled_bytes, spilled_bytes.fetch_add(size, std::memory_order_relaxed) + size);
+                return base;
+            }
+
+            // Returns false if the block is not a scratch mapping.
+            bool deallocate_mapped(void* user) {
+                MappedBlock block;
+                {
+                    std::lock_guard<std::mutex> lock(mapped_blocks_mutex);
+                    const std::size_t amount = mapped_blocks_amount.load(std::memory_order_relaxed);
+                    std::size_t i = 0;
+                    while (i < amount && mapped_blocks[i].base != user) {
+                        ++i;
+                    }
+                    if (i == amount) {
+                        return false;
+                    }
+                    block = mapped_blocks[i];
+                    mapped_blocks[i] = mapped_blocks[amount - 1];
+                    mapped_blocks_amount.store(amount - 1, std::memory_order_relaxed);
+                }
+                spilled_bytes.fetch_sub(block.size, std::memory_order_relaxed);
+                munmap(block.base, block.length);
+                return true;
+            }
+
+            // Released chunks wait in a ring, the functions below are called with arena_chunks_mutex held.
+            void put_free_arena_chunk(std::size_t index) {
+                free_arena_chunks[(first_free_arena_chunk + free_arena_chunks_amount++) % arena_chunks_capacity] =
+                    static_cast<std::uint32_t>(index);
+            }
+
+#ifdef NDEBUG
+            std::size_t take_newest_free_arena_chunk() {
+                return free_arena_chunks[(first_free_arena_chunk + --free_arena_chunks_amount) % arena_chunks_capacity];
+            }
+#else
+            std::size_t take_oldest_free_arena_chunk() {
+                const std::size_t index = free_arena_chunks[first_free_arena_chunk];
+                first_free_arena_chunk = (first_free_arena_chunk + 1) % arena_chunks_capacity;
+                --free_arena_chunks_amount;
+                return index;
+            }
+#endif
+
+            // Arena chunks are taken from a range reserved on first use, so that delete recognizes arena blocks by
+            // two comparisons.
+            void* acquire_arena_chunk() {
+                std::lock_guard<std::mutex> lock(arena_chunks_mutex);
+                if (arena_range.load(std::memory_order_relaxed) == 0) {
+                    if (arena_range_failed) {
+                        return nullptr;
+                    }
+                    void* range = mmap(
+                        nullptr, arena_chunk_size * arena_chunks_capacity, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0
+                    );
+                    if (range == MAP_FAILED) {
+                        arena_range_failed = true;
+                        return nullptr;
+                    }
+                    arena_range.store(reinterpret_cast<std::uintptr_t>(range), std::memory_order_release);
+                }
+
+                std::size_t index;
+#ifdef NDEBUG
+                if (free_arena_chunks_amount != 0) {
+                    index = take_newest_free_arena_chunk();
+                } else if (arena_chunks_used != arena_chunks_capacity) {
+                    index = arena_chunks_used++;
+                } else {
+                    return nullptr;
+                }
+#else
+                // Debug builds reuse a chunk only when the range is exhausted, and then the one released longest
+                // ago, so that a block used after its arena faults for as long as possible
+                if (arena_chunks_used != arena_chunks_capacity) {
+                    index = arena_chunks_used++;
+                } else if (free_arena_chunks_amount != 0) {
+                    index = take_oldest_free_arena_chunk();
+                } else {
+                    return nullptr;
+                }
+#endif
+                auto* chunk = reinterpret_cast<std::uint8_t*>(arena_range.load(std::memory_order_relaxed)) +
+                              index * arena_chunk_size;
+                if (mprotect(chunk, arena_chunk_size, PROT_READ | PROT_WRITE) != 0) {
+                    put_free_arena_chunk(index);
+                    return nullptr;
+                }
+                live_arena_chunks[index].store(true, std::memory_order_relaxed);
+                return chunk;
+            }
+
+            std::size_t arena_chunk_index(const void* block) {
+                return (reinterpret_cast<std::uintptr_t>(block) - arena_range.load(std::memory_order_relaxed)) /
+                       arena_chunk_size;
+            }
+
+            // Released chunks are made inaccessible, so that a block used after its arena is destroyed faults
+            // instead of reading memory of another arena.
+            void release_arena_chunk(void* chunk) {
+                const std::size_t index = arena_chunk_index(chunk);
+                live_arena_chunks[index].store(false, std::memory_order_relaxed);
+                // Pages are returned to the system, the address range stays reserved
+                madvise(chunk, arena_chunk_size, MADV_DONTNEED);
+                mprotect(chunk, arena_chunk_size, PROT_NONE);
+                std::lock_guard<std::mutex> lock(arena_chunks_mutex);
+                put_free_arena_chunk(index);
+            }
+
+            bool is_arena_block(const void* user) {
+                const std::uintptr_t range = arena_range.load(std::memory_order_acquire);
+                const auto address = reinterpret_cast<std::uintptr_t>(user);
+                return range != 0 && address >= range && address - range < arena_chunk_size * arena_chunks_capacity;
+            }
+
+            void* allocate_heap(std::size_t size, std::size_t alignment) {
+                if (alignment <= alignof(std::max_align_t)) {
+                    return std::malloc(size);
+                }
+                void* block = nullptr;
+                return posix_memalign(&block, alignment, size) == 0 ? block : nullptr;
+            }
+
+            void* allocate_accounted(std::size_t size, std::size_t alignment) {
+                CounterSlot& counters = thread_counters();
+                add_to_counter<std::uint64_t>(counters, counters.allocations, 1);
+                if (size >= min_spilled_allocation_size) {
+                    const std::uint64_t heap = current_heap_bytes();
+                    if (limit_enabled.load(std::memory_order_relaxed) && heap + size > memory_limit) {
+                        if (void* block = allocate_mapped(size, alignment)) {
+                            return block;
+                        }
+                        if (!scratch_failure_reported.exchange(true)) {
+                            // Printed without allocating, the heap might be exhausted already
+                            static const char message[] = "Unable to create scratch file, allocating over memory limit\n";
+                            [[maybe_unused]] auto written = ::write(STDERR_FILENO, message, sizeof(message) - 1);
+                        }
+                    }
+                    update_peak(peak_heap_bytes, heap + size);
+                }
+                void* block = allocate_heap(size, alignment);
+                if (block != nullptr) {
+                    add_to_counter<std::int64_t>(
+                        counters, counters.heap_bytes, static_cast<std::int64_t>(malloc_usable_size(block))
+                    );
+                }
+                return block;
+            }
+
+            void* allocate(std::size_t size, std::size_t alignment) {
+                if (current_arena != nullptr) {
+                    if (void* block = current_arena->allocate(size, alignment)) {
+                        return block;
+                    }
+                }
+                if (!accounting_enabled.load(std::memory_order_relaxed)) {
+                    return allocate_heap(size, alignment);
+                }
+                return allocate_accounted(size, alignment);
+            }
+
+            void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+                // Zero-sized allocations must return unique pointers
+                void* block = allocate(size == 0 ? 1 : size, alignment);
+                if (block == nullptr) {
+                    throw std::bad_alloc();
+                }
+                return block;
+            }
+
+            void deallocate(void* user) noexcept {
+                if (user == nullptr) {
+                    return;
+                }
+                if (is_arena_block(user)) {
+                    // Freed together with the arena, which must still exist
+                    assert(live_arena_chunks[arena_chunk_index(user)].load(std::memory_order_relaxed) &&
+                           "Block allocated in an ArenaScope outlived its arena");
+                    return;
+                }
+                if (mapped_blocks_amount.load(std::memory_order_relaxed) != 0 &&
+                    reinterpret_cast<std::uintptr_t>(user) % page_size() == 0 && deallocate_mapped(user)) {
+                    return;
+                }
+                if (accounting_enabled.load(std::memory_order_relaxed)) {
+                    CounterSlot& counters = thread_counters();
+                    add_to_counter<std::int64_t>(
+                        counters, counters.heap_bytes, -static_cast<std::int64_t>(malloc_usable_size(user))
+                    );
+                }
+                std::free(user);
+            }
+        } // namespace
+
+        void enable_allocation_accounting() {
+            accounting_enabled.store(true);
+        }
+
+        bool enable_memory_limit(std::uint64_t limit, const std::string& scratch_dir) {
+            if (scratch_dir.size() >= sizeof(scratch_directory)) {
+                BOOST_LOG_TRIVIAL(error) << "Scratch directory path is too long: " << scratch_dir;
+                return false;
+            }
+            if (access(scratch_dir.c_str(), W_OK) != 0) {
+                BOOST_LOG_TRIVIAL(error) << "Scratch directory " << scratch_dir << " is not writable";
+                return false;
+            }
+            // Pages of files on memory-backed file systems can't be written back to disk, spilling there saves nothing
+            struct statfs file_system;
+            if (statfs(scratch_dir.c_str(), &file_system) == 0 &&
+                (file_system.f_type == TMPFS_MAGIC || file_system.f_type == RAMFS_MAGIC)) {
+                BOOST_LOG_TRIVIAL(error) << "Scratch directory " << scratch_dir
+                                         << " is on a memory-backed file system, choose one on a disk";
+                return false;
+            }
+            std::memcpy(scratch_directory, scratch_dir.c_str(), scratch_dir.size() + 1);
+            memory_limit = limit;
+            enable_allocation_accounting();
+            limit_enabled.store(true);
+            BOOST_LOG_TRIVIAL(info) << "Allocations over " << (limit >> 20) << " MiB of heap go to scratch files in "
+                                    << scratch_dir;
+            return true;
+        }
+
+        AllocatorStatistics allocator_statistics() {
+            std::uint64_t allocations = 0;
+            for (const auto& slot : counter_slots) {
+                allocations += slot.allocations.load(std::memory_order_relaxed);
+            }
+            const std::uint64_t heap_bytes = current_heap_bytes();
+            update_peak(peak_heap_bytes, heap_bytes);
+            const std::uint64_t arena_allocations_amount = arena_allocations.load(std::memory_order_relaxed);
+            return {
+                heap_bytes,
+                peak_heap_bytes.load(std::memory_order_relaxed),
+                spilled_bytes.load(std::memory_order_relaxed),
+                peak_spilled_bytes.load(std::memory_order_relaxed),
+                allocations + arena_allocations_amount,
+                arena_allocations_amount
+            };
+        }
+
+        AllocationArena::~AllocationArena() {
+            while (chunks_ != nullptr) {
+                void* next = *static_cast<void**>(chunks_);
+                release_arena_chunk(chunks_);
+                chunks_ = next;
+            }
+            // Counted once per arena, so that arena allocations don't touch the shared counter
+            arena_allocations.fetch_add(allocations_, std::memory_order_relaxed);
+        }
+
+        void* AllocationArena::allocate(std::size_t size, std::size_t alignment) noexcept {
+            if (size > max_arena_allocation_size || alignment > alignof(std::max_align_t)) {
+                return nullptr;
+            }
+            // Blocks start at malloc-aligned positions, the first one of a chunk follows the chunk link
+            constexpr std::size_t block_alignment = alignof(std::max_align_t);
+            const std::size_t block_size = (size + block_alignment - 1) / block_alignment * block_alignment;
+            if (position_ == nullptr || static_cast<std::size_t>(end_ - position_) < block_size) {
+                void* chunk = acquire_arena_chunk();
+                if (chunk == nullptr) {
+                    return nullptr;
+                }
+                *static_cast<void**>(chunk) = chunks_;
+                chunks_ = chunk;
+                position_ = static_cast<std::uint8_t*>(chunk) + block_alignment;
+                end_ = static_cast<std::uint8_t*>(chunk) + arena_chunk_size;
+            }
+            void* user = position_;
+            position_ += block_size;
+            ++allocations_;
+            return user;
+        }
+
+        ArenaScope::ArenaScope(AllocationArena& arena)
+            : previous_(current_arena) {
+            current_arena = &arena;
+        }
+
+        ArenaScope::~ArenaScope() {
+            current_arena = previous_;
+        }
+
+    } // namespace proof_generator
+} // namespace nil
+
+void* operator new(std::size_t size) {
+    return nil::proof_generator::allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return nil::proof_generator::allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return nil::proof_generator::allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return nil::proof_generator::allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return nil::proof_generator::allocate(size == 0 ? 1 : size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return nil::proof_generator::allocate(size == 0 ? 1 : size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return nil::proof_generator::allocate(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return nil::proof_generator::allocate(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    nil::proof_generator::deallocate(ptr);
+}
@@ -73,22 +73,60 @@ namespace nil {
             // clang-format off
             auto options_appender = config.add_options()
                 ("stage", make_defaulted_option(prover_options.stage),
-                 "Stage of the prover to run, one of (all, preprocess, prove, verify). Defaults to 'all'.")
+                 "Stage of the prover to run, one of (all, preprocess, prove, verify, serve, convert-table, convert-circuit). Defaults to 'all'.")
                 ("proof,p", make_defaulted_option(prover_options.proof_file_path), "Proof file")
+                ("proofs", po::value(&prover_options.proof_file_paths)->multitoken(),
+                 "Proof files of the same circuit to verify in parallel in 'verify' stage, instead of --proof")
+                ("proof-format", make_defaulted_option(prover_options.proof_format),
+                 "Proof file format, one of (binary, hex). Binary is faster, hex is kept for compatibility. Defaults to 'hex'.")
                 ("json,j", make_defaulted_option(prover_options.json_file_path), "JSON proof file")
+                ("skip-json", po::bool_switch(&prover_options.skip_json),
+                 "Do not generate JSON proofs, they are needed only for recursive verification")
+                ("verify", po::value(&prover_options.verification_mode),
+                 "Verification of generated proofs, one of (sync, async, off). Defaults to 'sync' in 'all' stage and 'off' otherwise.")
                 ("common-data", make_defaulted_option(prover_options.preprocessed_common_data_path), "Preprocessed common data file")
                 ("preprocessed-data", make_defaulted_option(prover_options.preprocessed_public_data_path), "Preprocessed public data file")
                 ("commitment-state-file", make_defaulted_option(prover_options.commitment_scheme_state_path), "Commitment state data file")
+                ("compression-level", make_defaulted_option(prover_options.compression_level),
+                 "zstd level to compress written preprocessed data and commitment state files with, 0 disables compression. "
+                 "Compressed files are read by every stage without extra options.")
                 ("circuit", po::value(&prover_options.circuit_file_path), "Circuit input file")
                 ("assignment-table,t", po::value(&prover_options.assignment_table_file_path), "Assignment table input file")
                 ("assignment-description-file", po::value(&prover_options.assignment_description_file_path), "Assignment description file")
+                ("output", po::value(&prover_options.output_file_path), "Output file of 'convert-table' and 'convert-circuit' stages")
+                ("bundle", po::value(&prover_options.bundle_file_path),
+                 "Single file to write the proofs and the preprocessed data to in 'all' stage, instead of separate files")
+                ("preprocessing-cache", po::value(&prover_options.preprocessing_cache_path),
+                 "Directory to reuse public preprocessing results from in 'all' and 'preprocess' stages")
+                ("preprocessing-cache-limit", make_defaulted_option(prover_options.preprocessing_cache_limit_mb),
+                 "Size limit of the preprocessing cache in MiB, least recently used entries are removed above it. 0 means no limit.")
+                ("checkpoint-dir", po::value(&prover_options.checkpoint_dir_path),
+                 "Directory to store the preprocessed data and the proof of 'all' stage to as soon as each is ready")
+                ("resume", po::bool_switch(&prover_options.resume),
+                 "Take the steps of 'all' stage already stored in --checkpoint-dir for the same inputs from there")
+                ("batch", po::value(&prover_options.batch_path),
+                 "JSON manifest or directory of assignment tables to prove against the same circuit in 'all' or 'prove' stage")
                 ("log-level,l", make_defaulted_option(prover_options.log_level), "Log level (trace, debug, info, warning, error, fatal)")
-                ("elliptic-curve-type,e", make_defaulted_option(prover_options.elliptic_curve_type), "Elliptic curve type (pallas)")
+                ("metrics-out", po::value(&prover_options.metrics_file_path),
+                 "JSON file to write wall time, CPU time, peak RSS and I/O of each prover phase to")
+                ("memory-limit", make_defaulted_option(prover_options.memory_limit_mb),
+                 "Heap size in MiB above which large allocations are placed into scratch files and paged by the kernel. 0 means no limit.")
+                ("scratch-dir", po::value(&prover_options.scratch_dir_path),
+                 "Directory for scratch files of --memory-limit, on a disk-backed file system. Required with --memory-limit")
+                ("elliptic-curve-type,e", make_defaulted_option(prover_options.elliptic_curve_type), "Elliptic curve type (pallas, vesta)")
                 ("hash-type", make_defaulted_option(prover_options.hash_type), "Hash type (keccak, poseidon, sha256)")
                 ("lambda-param", make_defaulted_option(prover_options.lambda), "Lambda param (9)")
-                ("grind-param", make_defaulted_option(prover_options.grind), "Grind param (69)")
+                ("grind-param", make_defaulted_option(prover_options.grind), "Grind param, amount of FRI proof-of-work bits. 0 disables grinding.")
                 ("expand-factor,x", make_defaulted_option(prover_options.expand_factor), "Expand factor")
-                ("max-quotient-chunks,q", make_defaulted_option(prover_options.max_quotient_chunks), "Maximum quotient polynomial parts amount");
+                ("max-quotient-chunks,q", make_defaulted_option(prover_options.max_quotient_chunks), "Maximum quotient polynomial parts amount")
+                ("socket", po::value(&prover_options.socket_path), "Unix socket to accept requests on in 'serve' stage, stdin is used if not set")
+                ("server-cache-size", make_defaulted_option(prover_options.server_cache_size), "Maximum amount of circuits kept loaded in 'serve' stage")
+                ("parallel-jobs", make_defaulted_option(prover_options.parallel_jobs),
+                 "Amount of batch jobs to prove concurrently in 'prove' stage, available CPUs are split between them evenly")
+                ("cpu-pools", po::value(&prover_options.cpu_pools),
+                 "CPU pools for concurrent batch jobs in 'prove' stage, separated by ';', e.g. \"0-15;16-31\"")
+                ("numa-pools", po::bool_switch(&prover_options.numa_pools),
+                 "Run concurrent batch jobs in 'prove' stage on one CPU pool per NUMA node");
 
             // clang-format on
             po::options_description cmdline_options("nil; Proof Producer");
@@ -143,6 +181,11 @@ namespace nil {
 
             try {
                 check_exclusive_options(vm, {"verification-only", "skip-verification"});
+                check_exclusive_options(vm, {"parallel-jobs", "cpu-pools", "numa-pools"});
+                // The system temporary directory is often tmpfs, where scratch files would stay in memory
+                if (prover_options.memory_limit_mb != 0 && prover_options.scratch_dir_path.empty()) {
+                    throw std::logic_error("Option memory-limit requires scratch-dir");
+                }
             } catch (const std::logic_error& e) {
                 std::cerr << e.what() << std::endl;
                 std::cout << cmdline_options << std::endl;
@@ -188,7 +231,9 @@ namespace nil {
     if (NAME == str)               \
         return type_identity<TYPE>{};
 
-#define CURVE_TYPES X(nil::crypto3::algebra::curves::pallas, "pallas")
+#define CURVE_TYPES                                   \
+    X(nil::crypto3::algebra::curves::pallas, "pallas") \
+    X(nil::crypto3::algebra::curves::vesta, "vesta")
 #define X(type, name) TYPE_TO_STRING(type, name)
         GENERATE_WRITE_OPERATOR(CURVE_TYPES, CurvesVariant)
 #undef X
@@ -0,0 +1,363 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+
+// Times the prover stages on synthetic circuits of growing size and writes the per-phase metrics of every run
+// as JSON, to track prover performance across dependency updates. Circuits mix multiplication gates, high degree
+// gates and lookups, so that every argument of the prover is exercised.
+
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/program_options.hpp>
+
+#include <nil/crypto3/zk/snark/arithmetization/plonk/constraint.hpp>
+#include <nil/crypto3/zk/snark/arithmetization/plonk/gate.hpp>
+#include <nil/crypto3/zk/snark/arithmetization/plonk/variable.hpp>
+
+#include <nil/proof-generator/allocator.hpp>
+#include <nil/proof-generator/arg_parser.hpp>
+#include <nil/proof-generator/arithmetization_params.hpp>
+#include <nil/proof-generator/meta_utils.hpp>
+#include <nil/proof-generator/metrics.hpp>
+#include <nil/proof-generator/prover.hpp>
+
+#undef B0
+
+using namespace nil::proof_generator;
+
+namespace {
+    struct BenchOptions {
+        std::size_t min_rows_log = 10;
+        std::size_t max_rows_log = 16;
+        std::vector<std::size_t> gates = {1};
+        std::size_t power_gates = 0;
+        std::size_t lookup_gates = 0;
+        CurvesVariant elliptic_curve_type = type_identity<nil::crypto3::algebra::curves::pallas>{};
+        HashesVariant hash_type = type_identity<nil::crypto3::hashes::keccak_1600<256>>{};
+        std::size_t lambda = 9;
+        std::vector<std::size_t> grinds = {0};
+        std::size_t expand_factor = 2;
+        std::size_t max_quotient_chunks = 0;
+        boost::filesystem::path output_file_path = "bench.json";
+        boost::filesystem::path work_dir = boost::filesystem::temp_directory_path() / "proof-producer-bench";
+    };
+
+    std::optional<BenchOptions> parse_bench_args(int argc, char* argv[]) {
+        namespace po = boost::program_options;
+
+        BenchOptions options;
+        po::options_description description("Nil; Proof Producer Benchmark Options");
+        // clang-format off
+        description.add_options()
+            ("help,h", "Produce help message")
+            ("min-rows-log", po::value(&options.min_rows_log)->default_value(options.min_rows_log),
+             "Log2 of the rows amount of the smallest circuit")
+            ("max-rows-log", po::value(&options.max_rows_log)->default_value(options.max_rows_log),
+             "Log2 of the rows amount of the largest circuit, up to 24")
+            ("gates", po::value(&options.gates)->multitoken(),
+             "Amounts of multiplication gates to benchmark, each gate takes 3 witness columns and a selector. Defaults to 1.")
+            ("power-gates", po::value(&options.power_gates)->default_value(options.power_gates),
+             "Degree 5 gates added to every circuit, each gate takes 2 witness columns and a selector")
+            ("lookup-gates", po::value(&options.lookup_gates)->default_value(options.lookup_gates),
+             "Lookups into a table of row numbers added to every circuit, each takes a witness column")
+            ("elliptic-curve-type,e", po::value(&options.elliptic_curve_type)->default_value(options.elliptic_curve_type),
+             "Elliptic curve type (pallas, vesta)")
+            ("hash-type", po::value(&options.hash_type)->default_value(options.hash_type),
+             "Hash type (keccak, poseidon, sha256)")
+            ("lambda-param", po::value(&options.lambda)->default_value(options.lambda), "Lambda param")
+            ("grind", po::value(&options.grinds)->multitoken(),
+             "Grinding params to benchmark, every circuit is proved with each of them. Grinding time is the growth of "
+             "the prove phase over grind 0. Defaults to 0.")
+            ("expand-factor,x", po::value(&options.expand_factor)->default_value(options.expand_factor), "Expand factor")
+            ("max-quotient-chunks,q", po::value(&options.max_quotient_chunks)->default_value(options.max_quotient_chunks),
+             "Maximum quotient polynomial parts amount")
+            ("output,o", po::value(&options.output_file_path)->default_value(options.output_file_path),
+             "JSON file to write the results to")
+            ("work-dir", po::value(&options.work_dir)->default_value(options.work_dir),
+             "Directory for the intermediate circuit, table and proof files");
+        // clang-format on
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, description), vm);
+        po::notify(vm);
+        if (vm.count("help")) {
+            std::cout << description << std::endl;
+            return std::nullopt;
+        }
+        if (options.min_rows_log > options.max_rows_log || options.max_rows_log > 24) {
+            throw std::invalid_argument("Rows log range must be non-empty and end at 24 at most");
+        }
+        return options;
+    }
+
+    // Gates of a synthetic circuit. Columns are laid out by gate kind in this order:
+    //     multiplication gate i checks w[3i] * w[3i + 1] = w[3i + 2], with selector i
+    //     power gate i checks w[b + 1] = w[b]^5 for b = 3 * multiplication + 2i, with selector multiplication + i
+    //     lookup i looks w[3 * multiplication + 2 * power + i] up in the table of row numbers held in constant
+    //     column 0. All lookups share the next selector, and the table is enabled by the one after it.
+    struct GateMix {
+        std::size_t multiplication;
+        std::size_t power;
+        std::size_t lookup;
+
+        std::size_t witnesses_amount() const {
+            return 3 * multiplication + 2 * power + lookup;
+        }
+
+        std::size_t constants_amount() const {
+            return lookup == 0 ? 0 : 1;
+        }
+
+        std::size_t selectors_amount() const {
+            return multiplication + power + (lookup == 0 ? 0 : 2);
+        }
+    };
+
+    template<typename BlueprintField>
+    nil::crypto3::zk::snark::plonk_constraint_system<BlueprintField> make_synthetic_circuit(const GateMix& mix) {
+        using ConstraintSystem = nil::crypto3::zk::snark::plonk_constraint_system<BlueprintField>;
+        using Variable = nil::crypto3::zk::snark::plonk_variable<typename BlueprintField::value_type>;
+        using Constraint = nil::crypto3::zk::snark::plonk_constraint<BlueprintField>;
+        using Gate = nil::crypto3::zk::snark::plonk_gate<BlueprintField, Constraint>;
+        using LookupGate = typename ConstraintSystem::lookup_gates_container_type::value_type;
+        using LookupConstraint = typename decltype(LookupGate::constraints)::value_type;
+        using LookupTable = typename ConstraintSystem::lookup_tables_type::value_type;
+
+        std::vector<Gate> gates;
+        for (std::size_t i = 0; i < mix.multiplication; ++i) {
+            Constraint constraint = Variable(3 * i, 0) * Variable(3 * i + 1, 0) - Variable(3 * i + 2, 0);
+            gates.emplace_back(i, std::vector<Constraint>{constraint});
+        }
+        for (std::size_t i = 0; i < mix.power; ++i) {
+            const std::size_t base = 3 * mix.multiplication + 2 * i;
+            const Variable x(base, 0);
+            Constraint constraint = x * x * x * x * x - Variable(base + 1, 0);
+            gates.emplace_back(mix.multiplication + i, std::vector<Constraint>{constraint});
+        }
+
+        typename ConstraintSystem::lookup_gates_container_type lookup_gates;
+        typename ConstraintSystem::lookup_tables_type lookup_tables;
+        if (mix.lookup != 0) {
+            const std::size_t lookup_selector = mix.multiplication + mix.power;
+            LookupTable table;
+            table.tag_index = lookup_selector + 1;
+            table.columns_number = 1;
+            table.append_option({Variable(0, 0, true, Variable::column_type::constant)});
+            lookup_tables.push_back(table);
+
+            std::vector<LookupConstraint> constraints;
+            for (std::size_t i = 0; i < mix.lookup; ++i) {
+                LookupConstraint constraint;
+                // Table ids start from 1, 0 stands for the rows where lookups are disabled
+                constraint.table_id = 1;
+                constraint.lookup_input = {Variable(3 * mix.multiplication + 2 * mix.power + i, 0)};
+                constraints.push_back(constraint);
+            }
+            lookup_gates.emplace_back(lookup_selector, constraints);
+        }
+        return ConstraintSystem(gates, {}, lookup_gates, lookup_tables);
+    }
+
+    // Table satisfying make_synthetic_circuit, every gate and lookup is enabled on all usable rows.
+    template<typename ProverType>
+    std::pair<typename ProverType::TableDescription, typename ProverType::AssignmentTable> make_synthetic_table(
+        const GateMix& mix,
+        std::size_t rows_log
+    ) {
+        using Column = typename ProverType::Column;
+        using FieldValue = typename ProverType::BlueprintField::value_type;
+        using AssignmentTable = typename ProverType::AssignmentTable;
+
+        typename ProverType::TableDescription description(
+            mix.witnesses_amount(), 0, mix.constants_amount(), mix.selectors_amount());
+        description.rows_amount = std::size_t(1) << rows_log;
+        // The last row is left unassigned, as in the tables produced by the assigner
+        description.usable_rows_amount = description.rows_amount - 1;
+        const std::size_t usable_rows = description.usable_rows_amount;
+
+        std::vector<Column> witnesses(mix.witnesses_amount(), Column(description.rows_amount, FieldValue::zero()));
+        std::vector<Column> constants(mix.constants_amount(), Column(description.rows_amount, FieldValue::zero()));
+        std::vector<Column> selectors(mix.selectors_amount(), Column(description.rows_amount, FieldValue::zero()));
+        for (std::size_t row = 0; row < usable_rows; ++row) {
+            for (std::size_t gate = 0; gate < mix.multiplication; ++gate) {
+                const FieldValue a(row + 1);
+                const FieldValue b(row + gate + 2);
+                witnesses[3 * gate][row] = a;
+                witnesses[3 * gate + 1][row] = b;
+                witnesses[3 * gate + 2][row] = a * b;
+            }
+            for (std::size_t gate = 0; gate < mix.power; ++gate) {
+                const std::size_t base = 3 * mix.multiplication + 2 * gate;
+                const FieldValue x(row + gate + 1);
+                witnesses[base][row] = x;
+                witnesses[base + 1][row] = x * x * x * x * x;
+            }
+            for (std::size_t lookup = 0; lookup < mix.lookup; ++lookup) {
+                // Any row number is in the table, these are spread over it differently for each lookup
+                witnesses[3 * mix.multiplication + 2 * mix.power + lookup][row] =
+                    FieldValue((row * (lookup + 2) + lookup) % usable_rows);
+            }
+            if (mix.lookup != 0) {
+                constants[0][row] = FieldValue(row);
+            }
+            for (auto& selector : selectors) {
+                selector[row] = FieldValue::one();
+            }
+        }
+        return {
+            description,
+            AssignmentTable(
+                typename AssignmentTable::private_table_type(std::move(witnesses)),
+                typename AssignmentTable::public_table_type({}, std::move(constants), std::move(selectors))
+            )
+        };
+    }
+
+    // Runs all prover stages, including marshalling in both directions, on one synthetic circuit.
+    template<typename CurveType, typename HashType>
+    bool run_synthetic_circuit(
+        const BenchOptions& options,
+        std::size_t grind,
+        const GateMix& mix,
+        std::size_t rows_log
+    ) {
+        using ProverType = Prover<CurveType, HashType>;
+
+        const auto circuit_file = options.work_dir / "circuit.crct";
+        const auto assignment_table_file = options.work_dir / "assignment.tbl";
+        const auto proof_file = options.work_dir / "proof.bin";
+        const auto json_file = options.work_dir / "proof.json";
+
+        ProverType prover(options.lambda, options.expand_factor, options.max_quotient_chunks, grind);
+        {
+            auto phase = Metrics::instance().start_phase("generate_synthetic_circuit");
+            prover.set_circuit(make_synthetic_circuit<typename ProverType::BlueprintField>(mix));
+            auto [description, table] = make_synthetic_table<ProverType>(mix, rows_log);
+            prover.set_assignment_table(description, std::move(table));
+        }
+
+        return prover.save_circuit_to_file(circuit_file) &&
+               prover.save_assignment_table(assignment_table_file, false) &&
+               prover.read_circuit(circuit_file) &&
+               prover.read_assignment_table(assignment_table_file) &&
+               prover.preprocess_public_data() &&
+               prover.preprocess_private_data() &&
+               prover.generate_to_file(proof_file, json_file, detail::VerificationMode::OFF, detail::ProofFormat::BINARY) &&
+               prover.verify_from_file(proof_file, detail::ProofFormat::BINARY);
+    }
+
+    template<typename CurveType, typename HashType>
+    bool run_benchmarks(const BenchOptions& options) {
+        boost::filesystem::create_directories(options.work_dir);
+        Metrics::instance().enable();
+
+        std::ofstream out(options.output_file_path.string());
+        if (!out.is_open()) {
+            BOOST_LOG_TRIVIAL(error) << "Unable to open file: " << options.output_file_path;
+            return false;
+        }
+
+        bool result = true;
+        bool first_run = true;
+        out << std::setprecision(9) << "{\n  \"runs\": [";
+        for (std::size_t grind : options.grinds) {
+            for (std::size_t gates_amount : options.gates) {
+                const GateMix mix{gates_amount, options.power_gates, options.lookup_gates};
+                for (std::size_t rows_log = options.min_rows_log; rows_log <= options.max_rows_log; ++rows_log) {
+                    BOOST_LOG_TRIVIAL(info) << "Benchmarking " << mix.multiplication << " multiplication gates, "
+                                            << mix.power << " power gates and " << mix.lookup << " lookups on 2^"
+                                            << rows_log << " rows with grind " << grind;
+                    Metrics::instance().reset();
+                    const AllocatorStatistics allocations_before = allocator_statistics();
+                    bool run_result;
+                    try {
+                        run_result =
+                            run_synthetic_circuit<CurveType, HashType>(options, grind, mix, rows_log);
+                    } catch (const std::exception& e) {
+                        BOOST_LOG_TRIVIAL(error) << e.what();
+                        run_result = false;
+                    }
+                    result = result && run_result;
+                    const AllocatorStatistics allocations_after = allocator_statistics();
+
+                    out << (first_run ? "\n    " : ",\n    ");
+                    first_run = false;
+                    out << "{\"curve\": \"" << options.elliptic_curve_type << "\", \"hash\": \"" << options.hash_type
+                        << "\", \"grind\": " << grind << ", \"gates\": " << gates_amount
+                        << ", \"power_gates\": " << mix.power << ", \"lookup_gates\": " << mix.lookup
+                        << ", \"rows_log\": " << rows_log << ", \"success\": " << (run_result ? "true" : "false")
+                        << ", \"allocations\": " << allocations_after.allocations - allocations_before.allocations
+                        << ", \"arena_allocations\": "
+                        << allocations_after.arena_allocations - allocations_before.arena_allocations
+                        << ", \"phases\": [";
+                    const auto phases = Metrics::instance().phases();
+                    for (std::size_t i = 0; i < phases.size(); ++i) {
+                        out << (i == 0 ? "\n      " : ",\n      ");
+                        Metrics::write_phase(out, phases[i]);
+                    }
+                    out << "\n    ]}";
+                    // Results of finished runs are kept if a larger one is killed
+                    out.flush();
+                }
+            }
+        }
+        out << "\n  ]\n}\n";
+
+        if (out.fail()) {
+            BOOST_LOG_TRIVIAL(error) << "Error occurred during writing to file " << options.output_file_path;
+            return false;
+        }
+        return result;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::optional<BenchOptions> options;
+    try {
+        options = parse_bench_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (!options) {
+        return 0;
+    }
+
+    bool result = false;
+    pass_variant_type_to_template_func<CurvesVariant>(options->elliptic_curve_type, [&]<typename CurveTypeIdentity>() {
+        using CurveType = typename CurveTypeIdentity::type;
+        pass_variant_type_to_template_func<HashesVariant>(options->hash_type, [&]<typename HashTypeIdentity>() {
+            using HashType = typename HashTypeIdentity::type;
+            if constexpr (is_supported_hash<CurveType, HashType>::value) {
+                result = run_benchmarks<CurveType, HashType>(*options);
+            } else {
+                BOOST_LOG_TRIVIAL(error) << "Hash type " << options->hash_type << " is not supported with curve "
+                                         << options->elliptic_curve_type;
+            }
+        });
+    });
+    return result ? 0 : 1;
+}
@@ -17,84 +17,21 @@
 // limitations under the License.
 //---------------------------------------------------------------------------//
 
-#include <iostream>
+#include <cstdint>
 #include <optional>
-#include <utility>
 
-#include <nil/proof-generator/arg_parser.hpp>
-#include <nil/proof-generator/file_operations.hpp>
-#include <nil/proof-generator/prover.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
 
-#undef B0
+#include <nil/proof-generator/allocator.hpp>
+#include <nil/proof-generator/arg_parser.hpp>
+#include <nil/proof-generator/arithmetization_params.hpp>
+#include <nil/proof-generator/meta_utils.hpp>
+#include <nil/proof-generator/metrics.hpp>
+#include <nil/proof-generator/run_prover.hpp>
 
 using namespace nil::proof_generator;
 
-template<typename CurveType, typename HashType>
-int run_prover(const nil::proof_generator::ProverOptions& prover_options) {
-    auto prover_task = [&] {
-        auto prover = nil::proof_generator::Prover<CurveType, HashType>(
-            prover_options.lambda,
-            prover_options.expand_factor,
-            prover_options.max_quotient_chunks,
-            prover_options.grind
-        );
-        bool prover_result;
-        try {
-            switch (nil::proof_generator::detail::prover_stage_from_string(prover_options.stage)) {
-                case nil::proof_generator::detail::ProverStage::ALL:
-                    prover_result = 
-                        prover.read_circuit(prover_options.circuit_file_path) &&
-                        prover.read_assignment_table(prover_options.assignment_table_file_path) &&
-                        prover.preprocess_public_data() &&
-                        prover.preprocess_private_data() &&
-                        prover.generate_to_file(
-                            prover_options.proof_file_path, 
-                            prover_options.json_file_path,
-                            false/*don't skip verification*/) && 
-                        prover.save_preprocessed_common_data_to_file(prover_options.preprocessed_common_data_path) &&
-                        prover.save_public_preprocessed_data_to_file(prover_options.preprocessed_public_data_path) &&
-                        prover.save_commitment_state_to_file(prover_options.commitment_scheme_state_path);
-                    break;
-                case nil::proof_generator::detail::ProverStage::PREPROCESS:
-                    prover_result = 
-                        prover.read_circuit(prover_options.circuit_file_path) &&
-                        prover.read_assignment_table(prover_options.assignment_table_file_path) &&
-                        prover.save_assignment_description(prover_options.assignment_description_file_path) &&
-                        prover.preprocess_public_data() &&
-                        prover.save_preprocessed_common_data_to_file(prover_options.preprocessed_common_data_path) &&
-                        prover.save_public_preprocessed_data_to_file(prover_options.preprocessed_public_data_path) &&
-                        prover.save_commitment_state_to_file(prover_options.commitment_scheme_state_path);
-                    break;
-                case nil::proof_generator::detail::ProverStage::PROVE:
-                    // Load preprocessed data from file and generate the proof.
-                    prover_result =
-                        prover.read_circuit(prover_options.circuit_file_path) &&
-                        prover.read_assignment_table(prover_options.assignment_table_file_path) &&
-                        prover.read_public_preprocessed_data_from_file(prover_options.preprocessed_public_data_path) &&
-                        prover.read_commitment_scheme_from_file(prover_options.commitment_scheme_state_path) &&
-                        prover.preprocess_private_data() && 
-                        prover.generate_to_file(
-                            prover_options.proof_file_path,
-                            prover_options.json_file_path,
-                            true/*skip verification*/);
-                    break;
-                case nil::proof_generator::detail::ProverStage::VERIFY:
-                    prover_result = 
-                        prover.read_circuit(prover_options.circuit_file_path) &&
-                        prover.read_preprocessed_common_data_from_file(prover_options.preprocessed_common_data_path) &&
-                        prover.read_assignment_description(prover_options.assignment_description_file_path) &&
-                        prover.verify_from_file(prover_options.proof_file_path);
-                    break;
-            } 
-        } catch (const std::exception& e) {
-            BOOST_LOG_TRIVIAL(error) << e.what();
-            return 1;
-        }
-        return prover_result ? 0 : 1;
-    };
-    return prover_task();
-}
-
 // We could either make lambdas for generating Cartesian products of templates,
 // but this would lead to callback hell. Instead, we declare extra function for
 // each factor. Last declared function starts the chain.
@@ -103,7 +40,13 @@ int hash_wrapper(const ProverOptions& prover_options) {
     int ret;
     auto run_prover_wrapper_void = [&prover_options, &ret]<typename HashTypeIdentity>() {
         using HashType = typename HashTypeIdentity::type;
-        ret = run_prover<CurveType, HashType>(prover_options);
+        if constexpr (is_supported_hash<CurveType, HashType>::value) {
+            ret = run_prover<CurveType, HashType>(prover_options);
+        } else {
+            BOOST_LOG_TRIVIAL(error) << "Hash type " << prover_options.hash_type << " is not supported with curve "
+                                     << prover_options.elliptic_curve_type;
+            ret = 1;
+        }
     };
     pass_variant_type_to_template_func<HashesVariant>(prover_options.hash_type, run_prover_wrapper_void);
     return ret;
@@ -129,5 +72,20 @@ int main(int argc, char* argv[]) {
         // Action has already taken a place (help, version, etc.)
         return 0;
     }
-    return initial_wrapper(*prover_options);
+
+    if (prover_options->memory_limit_mb != 0) {
+        if (!nil::proof_generator::enable_memory_limit(
+                static_cast<std::uint64_t>(prover_options->memory_limit_mb) << 20,
+                prover_options->scratch_dir_path.string())) {
+            return 1;
+        }
+    }
+    if (!prover_options->metrics_file_path.empty()) {
+        nil::proof_generator::Metrics::instance().enable();
+    }
+    int ret = initial_wrapper(*prover_options);
+    if (!prover_options->metrics_file_path.empty()) {
+        nil::proof_generator::Metrics::instance().write_report(prover_options->metrics_file_path);
+    }
+    return ret;
 }
@@ -0,0 +1,459 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2021 Mikhail Komarov <nemo@nil.foundation>
+// Copyright (c) 2022 Aleksei Moskvin <alalmoskvin@nil.foundation>
+// Copyright (c) 2022 Ilia Shirobokov <i.shirobokov@nil.foundation>
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef PROOF_GENERATOR_RUN_PROVER_IMPL_HPP
+#define PROOF_GENERATOR_RUN_PROVER_IMPL_HPP
+
+// Definition of run_prover, included only by the translation units explicitly instantiating it for one curve and
+// hash pair each. These are generated by CMake from run_prover_instance.cpp.in.
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nil/proof-generator/arg_parser.hpp>
+#include <nil/proof-generator/batch.hpp>
+#include <nil/proof-generator/file_operations.hpp>
+#include <nil/proof-generator/metrics.hpp>
+#include <nil/proof-generator/parallel.hpp>
+#include <nil/proof-generator/preprocessing_cache.hpp>
+#include <nil/proof-generator/prover.hpp>
+#include <nil/proof-generator/prover_server.hpp>
+#include <nil/proof-generator/run_prover.hpp>
+#include <nil/proof-generator/scheduler.hpp>
+#include <nil/proof-generator/verifier.hpp>
+
+#undef B0
+
+// Checkpoints of 'all' stage are entries of a PreprocessingCache without a size limit, named by the step and the
+// input files key. Entries are published only when complete, so a process killed while storing one leaves no
+// partial checkpoint behind.
+struct Checkpoints {
+    using Artifacts = std::vector<nil::proof_generator::PreprocessingCache::Artifact>;
+
+    nil::proof_generator::PreprocessingCache directory;
+    nil::proof_generator::PreprocessingCache::Key key;
+    bool resume;
+
+    nil::proof_generator::PreprocessingCache::Key step_key(const std::string& step) const {
+        return {step + "-" + key.digest, key.fingerprint};
+    }
+
+    bool fetch(const std::string& step, const Artifacts& artifacts) const {
+        if (!resume || !directory.fetch(step_key(step), artifacts)) {
+            return false;
+        }
+        BOOST_LOG_TRIVIAL(info) << "Resuming after checkpoint " << step;
+        return true;
+    }
+
+    void store(const std::string& step, const Artifacts& artifacts) const {
+        directory.store(step_key(step), artifacts);
+    }
+};
+
+// Files written by public preprocessing, as they are stored in the preprocessing cache and in checkpoints.
+inline Checkpoints::Artifacts public_preprocessing_artifacts(const nil::proof_generator::ProverOptions& prover_options) {
+    return {
+        {"preprocessed_common_data.dat", prover_options.preprocessed_common_data_path},
+        {"preprocessed_data.dat", prover_options.preprocessed_public_data_path},
+        {"commitment_scheme_state.dat", prover_options.commitment_scheme_state_path}
+    };
+}
+
+// Preprocesses public data, or takes it from the checkpoints or the preprocessing cache if they are given, and writes
+// the preprocessed data files. Expects the circuit and the assignment table to be loaded.
+template<typename CurveType, typename HashType>
+bool preprocess_public_data_to_files(
+        nil::proof_generator::Prover<CurveType, HashType>& prover,
+        const nil::proof_generator::ProverOptions& prover_options,
+        const std::optional<Checkpoints>& checkpoints = std::nullopt) {
+    const auto artifacts = public_preprocessing_artifacts(prover_options);
+
+    if (checkpoints && checkpoints->fetch("public", artifacts)) {
+        return prover.read_public_preprocessed_data_from_file(prover_options.preprocessed_public_data_path) &&
+               prover.read_commitment_scheme_from_file(prover_options.commitment_scheme_state_path);
+    }
+
+    std::optional<nil::proof_generator::PreprocessingCache> cache;
+    std::optional<nil::proof_generator::PreprocessingCache::Key> cache_key;
+    if (!prover_options.preprocessing_cache_path.empty()) {
+        cache.emplace(
+            prover_options.preprocessing_cache_path,
+            static_cast<std::uint64_t>(prover_options.preprocessing_cache_limit_mb) << 20
+        );
+        cache_key = prover.public_preprocessing_key(prover_options.circuit_file_path);
+        if (cache_key && cache->fetch(*cache_key, artifacts)) {
+            return prover.read_public_preprocessed_data_from_file(prover_options.preprocessed_public_data_path) &&
+                   prover.read_commitment_scheme_from_file(prover_options.commitment_scheme_state_path);
+        }
+    }
+
+    // The files are independent, so they are serialized and written concurrently
+    bool result =
+        prover.preprocess_public_data() &&
+        nil::proof_generator::run_concurrently({
+            [&]() {
+                return prover.save_preprocessed_common_data_to_file(prover_options.preprocessed_common_data_path);
+            },
+            [&]() {
+                return prover.save_public_preprocessed_data_to_file(prover_options.preprocessed_public_data_path);
+            },
+            [&]() {
+                return prover.save_commitment_state_to_file(prover_options.commitment_scheme_state_path);
+            }
+        });
+    if (result && cache_key) {
+        cache->store(*cache_key, artifacts);
+    }
+    if (result && checkpoints) {
+        checkpoints->store("public", artifacts);
+    }
+    return result;
+}
+
+// Proves every job of the batch with the same preprocessed circuit. Expects the commitment scheme snapshot to be
+// saved, and the first assignment table to be already read if first_table_loaded is set.
+template<typename CurveType, typename HashType>
+bool prove_batch(
+        nil::proof_generator::Prover<CurveType, HashType>& prover,
+        const std::vector<nil::proof_generator::ProofJob>& jobs,
+        bool first_table_loaded,
+        nil::proof_generator::detail::VerificationMode verification_mode,
+        nil::proof_generator::detail::ProofFormat proof_format) {
+    bool batch_result = true;
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const auto& job = jobs[i];
+        BOOST_LOG_TRIVIAL(info) << "Batch job " << i + 1 << " of " << jobs.size() << ": "
+                                << job.assignment_table_file_path;
+        bool job_result;
+        try {
+            job_result =
+                // Public part of the tables was already committed during preprocessing
+                ((i == 0 && first_table_loaded) ||
+                 prover.read_private_assignment_table(job.assignment_table_file_path)) &&
+                prover.restore_commitment_scheme_snapshot() &&
+                prover.preprocess_private_data() &&
+                prover.generate_to_file(job.proof_file_path, job.json_file_path, verification_mode, proof_format);
+        } catch (const std::exception& e) {
+            BOOST_LOG_TRIVIAL(error) << e.what();
+            job_result = false;
+        }
+        // Verification may have started even if the job failed afterwards, it is finished before the next job
+        try {
+            job_result = prover.wait_for_verification() && job_result;
+        } catch (const std::exception& e) {
+            BOOST_LOG_TRIVIAL(error) << e.what();
+            job_result = false;
+        }
+        if (!job_result) {
+            BOOST_LOG_TRIVIAL(error) << "Batch job for " << job.assignment_table_file_path << " failed";
+            batch_result = false;
+        }
+    }
+    return batch_result;
+}
+
+template<typename CurveType, typename HashType>
+int run_prover(const nil::proof_generator::ProverOptions& prover_options) {
+    auto prover_task = [&] {
+        auto prover = nil::proof_generator::Prover<CurveType, HashType>(
+            prover_options.lambda,
+            prover_options.expand_factor,
+            prover_options.max_quotient_chunks,
+            prover_options.grind
+        );
+        prover.set_json_generation(!prover_options.skip_json);
+        prover.set_compression_level(prover_options.compression_level);
+        bool prover_result;
+        try {
+            const auto proof_format = nil::proof_generator::detail::proof_format_from_string(prover_options.proof_format);
+            const auto stage = nil::proof_generator::detail::prover_stage_from_string(prover_options.stage);
+            // Proofs are verified by default only when the whole pipeline runs in one process
+            const auto verification_mode = prover_options.verification_mode.empty()
+                ? (stage == nil::proof_generator::detail::ProverStage::ALL
+                       ? nil::proof_generator::detail::VerificationMode::SYNC
+                       : nil::proof_generator::detail::VerificationMode::OFF)
+                : nil::proof_generator::detail::verification_mode_from_string(prover_options.verification_mode);
+
+            std::optional<std::vector<nil::proof_generator::ProofJob>> batch;
+            if (!prover_options.batch_path.empty()) {
+                if (stage != nil::proof_generator::detail::ProverStage::ALL &&
+                    stage != nil::proof_generator::detail::ProverStage::PROVE) {
+                    throw std::invalid_argument("Batch is supported only for 'all' and 'prove' stages");
+                }
+                batch = nil::proof_generator::read_batch(prover_options.batch_path);
+                if (!batch) {
+                    return 1;
+                }
+            }
+
+            if (!prover_options.bundle_file_path.empty() &&
+                (stage != nil::proof_generator::detail::ProverStage::ALL || batch ||
+                 !prover_options.preprocessing_cache_path.empty())) {
+                throw std::invalid_argument(
+                    "Bundle is supported only for 'all' stage without a batch and a preprocessing cache");
+            }
+
+            std::optional<Checkpoints> checkpoints;
+            if (!prover_options.checkpoint_dir_path.empty()) {
+                if (stage != nil::proof_generator::detail::ProverStage::ALL || batch ||
+                    !prover_options.bundle_file_path.empty()) {
+                    throw std::invalid_argument(
+                        "Checkpoints are supported only for 'all' stage without a batch and a bundle");
+                }
+                const auto key = prover.input_files_key(
+                    prover_options.circuit_file_path, prover_options.assignment_table_file_path);
+                if (!key) {
+                    return 1;
+                }
+                checkpoints.emplace(Checkpoints{
+                    nil::proof_generator::PreprocessingCache(prover_options.checkpoint_dir_path, 0),
+                    *key,
+                    prover_options.resume
+                });
+            } else if (prover_options.resume) {
+                throw std::invalid_argument("Resume requires a checkpoint directory");
+            }
+
+            const auto cpu_pools = nil::proof_generator::cpu_pools_from_options(prover_options);
+            if (!cpu_pools.empty() && !(batch && stage == nil::proof_generator::detail::ProverStage::PROVE)) {
+                throw std::invalid_argument("Concurrent jobs are supported only for a batch in 'prove' stage");
+            }
+
+            // Stages are run as a task graph: inputs are read concurrently, and public and private preprocessing,
+            // which are independent, overlap as well. All tasks share the prover, so each of its members is written
+            // by one task only, and other tasks read it only if that task is among their dependencies:
+            //     read_circuit                               constraint_system_
+            //     read_assignment_table and its variants     assignment_table_, table_description_, public_inputs_,
+            //                                                  preprocessed_table_description_ for private tables
+            //     preprocess_public_data, with the cache,    lpc_scheme_, public_preprocessed_data_,
+            //       checkpoints, files or bundle around it     preprocessed_table_description_ and the public part
+            //                                                  of assignment_table_, which it moves out
+            //     preprocess_private_data                    private_preprocessed_data_ and the private part of
+            //                                                  assignment_table_, which it moves out
+            //     read_public_preprocessed_data_from_file    public_preprocessed_data_
+            //     read_commitment_scheme_from_file           lpc_scheme_
+            // Besides their own part of the table, both preprocessing tasks only read the circuit and the table
+            // description. The proving task depends on all the others and is the only one to release their data.
+            nil::proof_generator::TaskGraph graph;
+            const auto read_circuit = [&]() {
+                return prover.read_circuit(prover_options.circuit_file_path);
+            };
+            switch (stage) {
+                case nil::proof_generator::detail::ProverStage::ALL: {
+                    // Proof is the last checkpoint, the one of its format and with the JSON proof if it is needed.
+                    // A run resumed after it writes the same files as a complete one, so the preprocessed data of
+                    // the first checkpoint is restored as well.
+                    Checkpoints::Artifacts proof_artifacts = {
+                        {"proof", prover_options.proof_file_path}
+                    };
+                    if (!prover_options.skip_json) {
+                        proof_artifacts.emplace_back("proof.json", prover_options.json_file_path);
+                    }
+                    const std::string proof_step = "proof-" + prover_options.proof_format;
+                    if (checkpoints && checkpoints->fetch(proof_step, proof_artifacts) &&
+                        checkpoints->fetch("public", public_preprocessing_artifacts(prover_options))) {
+                        prover_result = true;
+                        break;
+                    }
+
+                    const auto circuit_read = graph.add(read_circuit);
+                    if (batch) {
+                        // Public data is preprocessed once, using the first table of the batch
+                        const auto table_read = graph.add([&]() {
+                            return prover.read_assignment_table(batch->front().assignment_table_file_path);
+                        });
+                        graph.add(
+                            [&]() {
+                                return preprocess_public_data_to_files(prover, prover_options) &&
+                                       prover.save_commitment_scheme_snapshot() &&
+                                       prove_batch(prover, *batch, true, verification_mode, proof_format);
+                            },
+                            {circuit_read, table_read}
+                        );
+                        prover_result = graph.run();
+                        break;
+                    }
+
+                    const auto table_read = graph.add([&]() {
+                        return prover.read_assignment_table(prover_options.assignment_table_file_path);
+                    });
+                    const auto private_preprocessed = graph.add(
+                        [&]() {
+                            return prover.preprocess_private_data();
+                        },
+                        {circuit_read, table_read}
+                    );
+                    if (!prover_options.bundle_file_path.empty()) {
+                        // All artifacts go to the bundle, no separate files are written
+                        const auto public_preprocessed = graph.add(
+                            [&]() {
+                                return prover.preprocess_public_data() &&
+                                       prover.start_bundle(prover_options.bundle_file_path);
+                            },
+                            {circuit_read, table_read}
+                        );
+                        graph.add(
+                            [&]() {
+                                return prover.generate_to_bundle(verification_mode) && prover.wait_for_verification();
+                            },
+                            {public_preprocessed, private_preprocessed}
+                        );
+                        prover_result = graph.run();
+                        break;
+                    }
+                    // Commitment state is saved before the prover appends its own batches to it, as in 'preprocess'
+                    // stage
+                    const auto public_preprocessed = graph.add(
+                        [&]() {
+                            return preprocess_public_data_to_files(prover, prover_options, checkpoints);
+                        },
+                        {circuit_read, table_read}
+                    );
+                    graph.add(
+                        [&]() {
+                            bool result = prover.generate_to_file(
+                                              prover_options.proof_file_path,
+                                              prover_options.json_file_path,
+                                              verification_mode,
+                                              proof_format) &&
+                                          prover.wait_for_verification();
+                            if (result && checkpoints) {
+                                checkpoints->store(proof_step, proof_artifacts);
+                            }
+                            return result;
+                        },
+                        {public_preprocessed, private_preprocessed}
+                    );
+                    prover_result = graph.run();
+                    break;
+                }
+                case nil::proof_generator::detail::ProverStage::PREPROCESS: {
+                    const auto circuit_read = graph.add(read_circuit);
+                    const auto table_read = graph.add([&]() {
+                        return prover.read_assignment_table(prover_options.assignment_table_file_path);
+                    });
+                    graph.add(
+                        [&]() {
+                            return prover.save_assignment_description(prover_options.assignment_description_file_path);
+                        },
+                        {table_read}
+                    );
+                    graph.add(
+                        [&]() {
+                            return preprocess_public_data_to_files(prover, prover_options);
+                        },
+                        {circuit_read, table_read}
+                    );
+                    prover_result = graph.run();
+                    break;
+                }
+                case nil::proof_generator::detail::ProverStage::PROVE: {
+                    if (batch && !cpu_pools.empty()) {
+                        // Workers load the preprocessed circuit themselves, nothing is loaded here
+                        prover_result = nil::proof_generator::ProofScheduler(
+                                            nil::proof_generator::make_worker_args(prover_options),
+                                            cpu_pools
+                        )
+                                            .run(*batch);
+                        break;
+                    }
+                    const auto circuit_read = graph.add(read_circuit);
+                    const auto public_data_read = graph.add([&]() {
+                        return prover.read_public_preprocessed_data_from_file(
+                            prover_options.preprocessed_public_data_path);
+                    });
+                    const auto commitment_scheme_read = graph.add([&]() {
+                        return prover.read_commitment_scheme_from_file(prover_options.commitment_scheme_state_path);
+                    });
+                    if (batch) {
+                        graph.add(
+                            [&]() {
+                                return prover.save_commitment_scheme_snapshot() &&
+                                       prove_batch(prover, *batch, false, verification_mode, proof_format);
+                            },
+                            {circuit_read, public_data_read, commitment_scheme_read}
+                        );
+                        prover_result = graph.run();
+                        break;
+                    }
+                    // Load preprocessed data from file and generate the proof.
+                    const auto table_read = graph.add([&]() {
+                        return prover.read_private_assignment_table(prover_options.assignment_table_file_path);
+                    });
+                    const auto private_preprocessed = graph.add(
+                        [&]() {
+                            return prover.preprocess_private_data();
+                        },
+                        {circuit_read, table_read}
+                    );
+                    graph.add(
+                        [&]() {
+                            return prover.generate_to_file(
+                                       prover_options.proof_file_path,
+                                       prover_options.json_file_path,
+                                       verification_mode,
+                                       proof_format) &&
+                                   prover.wait_for_verification();
+                        },
+                        {private_preprocessed, public_data_read, commitment_scheme_read}
+                    );
+                    prover_result = graph.run();
+                    break;
+                }
+                case nil::proof_generator::detail::ProverStage::VERIFY:
+                    return nil::proof_generator::run_verifier<CurveType, HashType>(prover_options);
+                case nil::proof_generator::detail::ProverStage::CONVERT_TABLE:
+                    // Marshalling tables are converted to the columnar format and vice versa
+                    prover_result =
+                        prover.read_assignment_table(prover_options.assignment_table_file_path) &&
+                        prover.save_assignment_table(
+                            prover_options.output_file_path,
+                            !nil::proof_generator::SectionedFile::is_sectioned_file(
+                                prover_options.assignment_table_file_path.string()
+                            )
+                        );
+                    break;
+                case nil::proof_generator::detail::ProverStage::CONVERT_CIRCUIT:
+                    // Marshalling circuits are converted to the sectioned format and vice versa
+                    prover_result =
+                        prover.read_circuit(prover_options.circuit_file_path) &&
+                        prover.save_circuit_to_file(
+                            prover_options.output_file_path,
+                            nil::proof_generator::SectionedFile::kind(prover_options.circuit_file_path.string()) !=
+                                nil::proof_generator::SectionedFileKind::CIRCUIT
+                        );
+                    break;
+                case nil::proof_generator::detail::ProverStage::SERVE:
+                    return nil::proof_generator::ProverServer<CurveType, HashType>(prover_options).run();
+            }
+        } catch (const std::exception& e) {
+            BOOST_LOG_TRIVIAL(error) << e.what();
+            return 1;
+        }
+        return prover_result ? 0 : 1;
+    };
+    return prover_task();
+}
+
+#endif // PROOF_GENERATOR_RUN_PROVER_IMPL_HPP
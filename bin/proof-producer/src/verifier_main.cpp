@@ -0,0 +1,84 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2018-2021 Mikhail Komarov <nemo@nil.foundation>
+// Copyright (c) 2022 Aleksei Moskvin <alalmoskvin@nil.foundation>
+// Copyright (c) 2022 Ilia Shirobokov <i.shirobokov@nil.foundation>
+// Copyright (c) 2024 Iosif (x-mass) <x-mass@nil.foundation>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+// Standalone verifier: accepts the options of 'verify' stage and instantiates only the verifier, so it builds and
+// starts faster than the prover.
+
+#include <optional>
+
+#include <boost/log/trivial.hpp>
+
+#include <nil/proof-generator/arg_parser.hpp>
+#include <nil/proof-generator/arithmetization_params.hpp>
+#include <nil/proof-generator/meta_utils.hpp>
+#include <nil/proof-generator/metrics.hpp>
+#include <nil/proof-generator/verifier.hpp>
+
+#undef B0
+
+using namespace nil::proof_generator;
+
+template<typename CurveType>
+int hash_wrapper(const ProverOptions& prover_options) {
+    int ret;
+    auto run_verifier_wrapper_void = [&prover_options, &ret]<typename HashTypeIdentity>() {
+        using HashType = typename HashTypeIdentity::type;
+        if constexpr (is_supported_hash<CurveType, HashType>::value) {
+            ret = run_verifier<CurveType, HashType>(prover_options);
+        } else {
+            BOOST_LOG_TRIVIAL(error) << "Hash type " << prover_options.hash_type << " is not supported with curve "
+                                     << prover_options.elliptic_curve_type;
+            ret = 1;
+        }
+    };
+    pass_variant_type_to_template_func<HashesVariant>(prover_options.hash_type, run_verifier_wrapper_void);
+    return ret;
+}
+
+int curve_wrapper(const ProverOptions& prover_options) {
+    int ret;
+    auto curves_wrapper_void = [&prover_options, &ret]<typename CurveTypeIdentity>() {
+        using CurveType = typename CurveTypeIdentity::type;
+        ret = hash_wrapper<CurveType>(prover_options);
+    };
+    pass_variant_type_to_template_func<CurvesVariant>(prover_options.elliptic_curve_type, curves_wrapper_void);
+    return ret;
+}
+
+int main(int argc, char* argv[]) {
+    std::optional<ProverOptions> prover_options = parse_args(argc, argv);
+    if (!prover_options) {
+        // Action has already taken a place (help, version, etc.)
+        return 0;
+    }
+    // 'all' is the default stage of the shared options
+    if (prover_options->stage != "all" && prover_options->stage != "verify") {
+        BOOST_LOG_TRIVIAL(error) << "proof-verifier runs only 'verify' stage";
+        return 1;
+    }
+
+    if (!prover_options->metrics_file_path.empty()) {
+        Metrics::instance().enable();
+    }
+    int ret = curve_wrapper(*prover_options);
+    if (!prover_options->metrics_file_path.empty()) {
+        Metrics::instance().write_report(prover_options->metrics_file_path);
+    }
+    return ret;
+}
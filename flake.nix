@@ -41,6 +41,7 @@
                 cmake
                 ninja
                 pkg-config
+                zstd
                 (if custom-boost == null then crypto3.packages.${system}.crypto3 else crypto3-with-custom-boost)
                 (if custom-boost == null then parallel-crypto3.packages.${system}.default else parallel-crypto3-with-custom-boost)
               ];
@@ -56,6 +57,7 @@
 
               cmakeFlags = [
                 "-DCMAKE_INSTALL_PREFIX=${placeholder "out"}"
+                "-DPROOF_GENERATOR_WITH_ZSTD=ON"
                 (if enableDebug then "-DCMAKE_BUILD_TYPE=Debug" else "-DCMAKE_BUILD_TYPE=Release")
                 (if enableDebug then "-DZK_PLACEHOLDER_DEBUG_ENABLED=1 -DCMAKE_CXX_FLAGS=-ggdb -DCMAKE_CXX_FLAGS=-O0" else "")
               ];